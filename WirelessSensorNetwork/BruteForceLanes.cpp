@@ -0,0 +1,374 @@
+#include "WSNPCH.h"
+#include "BruteForceLanes.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define WSN_LANES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WSN_TARGET_AVX2
+#define WSN_TARGET_AVX512
+#else
+#include <immintrin.h>
+#define WSN_TARGET_AVX2 __attribute__((target("avx2")))
+#define WSN_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace WSN
+{
+	// The lanes follow Simulation::AdvanceBruteForceClosedForm step by step, one failure point at a time :
+	// a lane in Collection completes floor(span / cycleTime) cycles or finishes, then every unfinished lane
+	// goes through Recovery, which either reaches Collection again or is cut short by the next failure.
+
+	static void ThrowExceededLastFailurePoint()
+	{
+		throw std::runtime_error("Exceeded the last failure point!");
+	}
+
+	static void AdvanceLanesScalar(BruteForceLaneGroup& group, const FailureStream& failures, long long failureEnd, const BruteForceLaneParameters& params)
+	{
+		unsigned int active = group.ActiveMask;
+
+		for (long long k = group.FailureIterator; active != 0 && k < failureEnd; k++)
+		{
+			if (!failures.Has(k))
+				ThrowExceededLastFailurePoint();
+
+			const long long failureTime = failures[k];
+
+			for (int lane = 0; lane < BruteForceLaneGroup::c_LaneCount; lane++)
+			{
+				if (!(active & (1u << lane)) || group.CollectionStart[lane] < 0)
+					continue;
+
+				const long long delta = (long long)group.Delta[lane];
+				const long long cycleTime = delta + params.TransferTime;
+				const long long collectionStart = (long long)group.CollectionStart[lane];
+				const long long transferred = (long long)group.TransferredTotalDuration[lane];
+				const long long span = failureTime - collectionStart;
+				const long long completedCycles = span / cycleTime;
+				const long long remainingCycles = (params.TotalDurationToBeTransferred - transferred + delta - 1) / delta;
+
+				if (remainingCycles <= completedCycles)
+				{
+					group.CollectionTime[lane] += (double)(remainingCycles * delta);
+					group.WastedTime[lane] += (double)(remainingCycles * params.TransferTime);
+					group.ActualTotalDuration[lane] = (double)(collectionStart + remainingCycles * cycleTime);
+					group.FinalFailureIndex[lane] = (double)(k - 1);
+					active &= ~(1u << lane);
+				}
+				else
+				{
+					group.CollectionTime[lane] += (double)(completedCycles * delta);
+					group.WastedTime[lane] += (double)(completedCycles * params.TransferTime + span - completedCycles * cycleTime);
+					group.TransferredTotalDuration[lane] += (double)(completedCycles * delta);
+				}
+			}
+
+			if (active == 0)
+				break;
+
+			if (!failures.Has(k + 1))
+				ThrowExceededLastFailurePoint();
+
+			const long long nextFailureTime = failures[k + 1];
+			const bool recoveryFails = failureTime + params.RecoveryTime > nextFailureTime;
+
+			for (int lane = 0; lane < BruteForceLaneGroup::c_LaneCount; lane++)
+			{
+				if (!(active & (1u << lane)))
+					continue;
+
+				if (recoveryFails)
+				{
+					group.WastedTime[lane] += (double)(nextFailureTime - failureTime);
+					group.CollectionStart[lane] = -1.0;
+				}
+				else
+				{
+					group.WastedTime[lane] += (double)params.RecoveryTime;
+					group.CollectionStart[lane] = (double)(failureTime + params.RecoveryTime);
+				}
+			}
+		}
+
+		group.ActiveMask = active;
+	}
+
+#if WSN_LANES_X86
+	WSN_TARGET_AVX2 static inline __m256d FloorDivideAVX2(__m256d a, __m256d b, __m256d bInverse, __m256d one)
+	{
+		// multiplying by the rounded inverse can put the quotient one off, the two corrections make it exact
+		__m256d q = _mm256_floor_pd(_mm256_mul_pd(a, bInverse));
+		q = _mm256_sub_pd(q, _mm256_and_pd(_mm256_cmp_pd(_mm256_mul_pd(q, b), a, _CMP_GT_OQ), one));
+		q = _mm256_add_pd(q, _mm256_and_pd(_mm256_cmp_pd(_mm256_mul_pd(_mm256_add_pd(q, one), b), a, _CMP_LE_OQ), one));
+		return q;
+	}
+
+	// lanes [offset, offset + 4) of the group
+	WSN_TARGET_AVX2 static void AdvanceLanesAVX2(BruteForceLaneGroup& group, int offset, const FailureStream& failures, long long failureEnd, const BruteForceLaneParameters& params)
+	{
+		const __m256i laneBits = _mm256_set_epi64x(8, 4, 2, 1);
+		__m256d active = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x((group.ActiveMask >> offset) & 0xF), laneBits), laneBits));
+
+		if (_mm256_movemask_pd(active) == 0)
+			return;
+
+		const __m256d one = _mm256_set1_pd(1.0);
+		const __m256d zero = _mm256_setzero_pd();
+		const __m256d transferTime = _mm256_set1_pd((double)params.TransferTime);
+		const __m256d recoveryTime = _mm256_set1_pd((double)params.RecoveryTime);
+		const __m256d total = _mm256_set1_pd((double)params.TotalDurationToBeTransferred);
+		const __m256d delta = _mm256_load_pd(group.Delta + offset);
+		const __m256d deltaMinusOne = _mm256_sub_pd(delta, one);
+		const __m256d cycleTime = _mm256_add_pd(delta, transferTime);
+		const __m256d deltaInverse = _mm256_div_pd(one, delta);
+		const __m256d cycleTimeInverse = _mm256_div_pd(one, cycleTime);
+
+		__m256d collectionStart = _mm256_load_pd(group.CollectionStart + offset);
+		__m256d transferred = _mm256_load_pd(group.TransferredTotalDuration + offset);
+		__m256d collectionTime = _mm256_load_pd(group.CollectionTime + offset);
+		__m256d wastedTime = _mm256_load_pd(group.WastedTime + offset);
+		__m256d actualTotalDuration = _mm256_load_pd(group.ActualTotalDuration + offset);
+		__m256d finalFailureIndex = _mm256_load_pd(group.FinalFailureIndex + offset);
+
+		for (long long k = group.FailureIterator; _mm256_movemask_pd(active) != 0 && k < failureEnd; k++)
+		{
+			if (!failures.Has(k))
+				ThrowExceededLastFailurePoint();
+
+			const __m256d failureTime = _mm256_set1_pd((double)failures[k]);
+
+			const __m256d inCollection = _mm256_and_pd(active, _mm256_cmp_pd(collectionStart, zero, _CMP_GE_OQ));
+			const __m256d span = _mm256_sub_pd(failureTime, collectionStart);
+			const __m256d completedCycles = FloorDivideAVX2(span, cycleTime, cycleTimeInverse, one);
+			const __m256d remainingCycles = FloorDivideAVX2(_mm256_add_pd(_mm256_sub_pd(total, transferred), deltaMinusOne), delta, deltaInverse, one);
+
+			const __m256d finishing = _mm256_and_pd(inCollection, _mm256_cmp_pd(remainingCycles, completedCycles, _CMP_LE_OQ));
+			const __m256d continuing = _mm256_andnot_pd(finishing, inCollection);
+
+			const __m256d cycles = _mm256_blendv_pd(completedCycles, remainingCycles, finishing);
+			const __m256d leftover = _mm256_and_pd(continuing, _mm256_sub_pd(span, _mm256_mul_pd(completedCycles, cycleTime)));
+
+			collectionTime = _mm256_add_pd(collectionTime, _mm256_and_pd(inCollection, _mm256_mul_pd(cycles, delta)));
+			wastedTime = _mm256_add_pd(wastedTime, _mm256_add_pd(_mm256_and_pd(inCollection, _mm256_mul_pd(cycles, transferTime)), leftover));
+			transferred = _mm256_add_pd(transferred, _mm256_and_pd(continuing, _mm256_mul_pd(completedCycles, delta)));
+
+			actualTotalDuration = _mm256_blendv_pd(actualTotalDuration, _mm256_add_pd(collectionStart, _mm256_mul_pd(remainingCycles, cycleTime)), finishing);
+			finalFailureIndex = _mm256_blendv_pd(finalFailureIndex, _mm256_set1_pd((double)(k - 1)), finishing);
+			active = _mm256_andnot_pd(finishing, active);
+
+			if (_mm256_movemask_pd(active) == 0)
+				break;
+
+			if (!failures.Has(k + 1))
+				ThrowExceededLastFailurePoint();
+
+			const __m256d nextFailureTime = _mm256_set1_pd((double)failures[k + 1]);
+			const __m256d recoveryEnd = _mm256_add_pd(failureTime, recoveryTime);
+			const __m256d recoveryFails = _mm256_cmp_pd(recoveryEnd, nextFailureTime, _CMP_GT_OQ);
+
+			const __m256d recoveryWaste = _mm256_blendv_pd(recoveryTime, _mm256_sub_pd(nextFailureTime, failureTime), recoveryFails);
+			wastedTime = _mm256_add_pd(wastedTime, _mm256_and_pd(active, recoveryWaste));
+			collectionStart = _mm256_blendv_pd(collectionStart, _mm256_blendv_pd(recoveryEnd, _mm256_set1_pd(-1.0), recoveryFails), active);
+		}
+
+		_mm256_store_pd(group.CollectionStart + offset, collectionStart);
+		_mm256_store_pd(group.TransferredTotalDuration + offset, transferred);
+		_mm256_store_pd(group.CollectionTime + offset, collectionTime);
+		_mm256_store_pd(group.WastedTime + offset, wastedTime);
+		_mm256_store_pd(group.ActualTotalDuration + offset, actualTotalDuration);
+		_mm256_store_pd(group.FinalFailureIndex + offset, finalFailureIndex);
+
+		group.ActiveMask = (group.ActiveMask & ~(0xFu << offset)) | ((unsigned int)_mm256_movemask_pd(active) << offset);
+	}
+
+	WSN_TARGET_AVX512 static inline __m512d FloorDivideAVX512(__m512d a, __m512d b, __m512d bInverse, __m512d one)
+	{
+		// multiplying by the rounded inverse can put the quotient one off, the two corrections make it exact
+		__m512d q = _mm512_roundscale_pd(_mm512_mul_pd(a, bInverse), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+		q = _mm512_mask_sub_pd(q, _mm512_cmp_pd_mask(_mm512_mul_pd(q, b), a, _CMP_GT_OQ), q, one);
+		q = _mm512_mask_add_pd(q, _mm512_cmp_pd_mask(_mm512_mul_pd(_mm512_add_pd(q, one), b), a, _CMP_LE_OQ), q, one);
+		return q;
+	}
+
+	WSN_TARGET_AVX512 static void AdvanceLanesAVX512(BruteForceLaneGroup& group, const FailureStream& failures, long long failureEnd, const BruteForceLaneParameters& params)
+	{
+		__mmask8 active = (__mmask8)group.ActiveMask;
+
+		const __m512d one = _mm512_set1_pd(1.0);
+		const __m512d zero = _mm512_setzero_pd();
+		const __m512d transferTime = _mm512_set1_pd((double)params.TransferTime);
+		const __m512d recoveryTime = _mm512_set1_pd((double)params.RecoveryTime);
+		const __m512d total = _mm512_set1_pd((double)params.TotalDurationToBeTransferred);
+		const __m512d delta = _mm512_load_pd(group.Delta);
+		const __m512d deltaMinusOne = _mm512_sub_pd(delta, one);
+		const __m512d cycleTime = _mm512_add_pd(delta, transferTime);
+		const __m512d deltaInverse = _mm512_div_pd(one, delta);
+		const __m512d cycleTimeInverse = _mm512_div_pd(one, cycleTime);
+
+		__m512d collectionStart = _mm512_load_pd(group.CollectionStart);
+		__m512d transferred = _mm512_load_pd(group.TransferredTotalDuration);
+		__m512d collectionTime = _mm512_load_pd(group.CollectionTime);
+		__m512d wastedTime = _mm512_load_pd(group.WastedTime);
+		__m512d actualTotalDuration = _mm512_load_pd(group.ActualTotalDuration);
+		__m512d finalFailureIndex = _mm512_load_pd(group.FinalFailureIndex);
+
+		for (long long k = group.FailureIterator; active != 0 && k < failureEnd; k++)
+		{
+			if (!failures.Has(k))
+				ThrowExceededLastFailurePoint();
+
+			const __m512d failureTime = _mm512_set1_pd((double)failures[k]);
+
+			const __mmask8 inCollection = _mm512_mask_cmp_pd_mask(active, collectionStart, zero, _CMP_GE_OQ);
+			const __m512d span = _mm512_sub_pd(failureTime, collectionStart);
+			const __m512d completedCycles = FloorDivideAVX512(span, cycleTime, cycleTimeInverse, one);
+			const __m512d remainingCycles = FloorDivideAVX512(_mm512_add_pd(_mm512_sub_pd(total, transferred), deltaMinusOne), delta, deltaInverse, one);
+
+			const __mmask8 finishing = _mm512_mask_cmp_pd_mask(inCollection, remainingCycles, completedCycles, _CMP_LE_OQ);
+			const __mmask8 continuing = inCollection & ~finishing;
+
+			const __m512d cycles = _mm512_mask_blend_pd(finishing, completedCycles, remainingCycles);
+
+			collectionTime = _mm512_mask_add_pd(collectionTime, inCollection, collectionTime, _mm512_mul_pd(cycles, delta));
+			wastedTime = _mm512_mask_add_pd(wastedTime, inCollection, wastedTime, _mm512_mul_pd(cycles, transferTime));
+			wastedTime = _mm512_mask_add_pd(wastedTime, continuing, wastedTime, _mm512_sub_pd(span, _mm512_mul_pd(completedCycles, cycleTime)));
+			transferred = _mm512_mask_add_pd(transferred, continuing, transferred, _mm512_mul_pd(completedCycles, delta));
+
+			actualTotalDuration = _mm512_mask_blend_pd(finishing, actualTotalDuration, _mm512_add_pd(collectionStart, _mm512_mul_pd(remainingCycles, cycleTime)));
+			finalFailureIndex = _mm512_mask_blend_pd(finishing, finalFailureIndex, _mm512_set1_pd((double)(k - 1)));
+			active &= ~finishing;
+
+			if (active == 0)
+				break;
+
+			if (!failures.Has(k + 1))
+				ThrowExceededLastFailurePoint();
+
+			const __m512d nextFailureTime = _mm512_set1_pd((double)failures[k + 1]);
+			const __m512d recoveryEnd = _mm512_add_pd(failureTime, recoveryTime);
+			const __mmask8 recoveryFails = _mm512_cmp_pd_mask(recoveryEnd, nextFailureTime, _CMP_GT_OQ);
+
+			const __m512d recoveryWaste = _mm512_mask_blend_pd(recoveryFails, recoveryTime, _mm512_sub_pd(nextFailureTime, failureTime));
+			wastedTime = _mm512_mask_add_pd(wastedTime, active, wastedTime, recoveryWaste);
+			collectionStart = _mm512_mask_blend_pd(active, collectionStart, _mm512_mask_blend_pd(recoveryFails, recoveryEnd, _mm512_set1_pd(-1.0)));
+		}
+
+		_mm512_store_pd(group.CollectionStart, collectionStart);
+		_mm512_store_pd(group.TransferredTotalDuration, transferred);
+		_mm512_store_pd(group.CollectionTime, collectionTime);
+		_mm512_store_pd(group.WastedTime, wastedTime);
+		_mm512_store_pd(group.ActualTotalDuration, actualTotalDuration);
+		_mm512_store_pd(group.FinalFailureIndex, finalFailureIndex);
+
+		group.ActiveMask = active;
+	}
+#endif
+
+	static LaneInstructionSet DetectLaneInstructionSet()
+	{
+#if WSN_LANES_X86
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return LaneInstructionSet::Scalar;
+
+		__cpuid(info, 1);
+		bool osxsave = info[2] & (1 << 27);
+		if (!osxsave)
+			return LaneInstructionSet::Scalar;
+
+		// the OS has to save the ymm (and zmm) registers as well
+		unsigned long long xcr0 = _xgetbv(0);
+
+		__cpuidex(info, 7, 0);
+		bool avx2 = info[1] & (1 << 5);
+		bool avx512f = info[1] & (1 << 16);
+
+		if (avx512f && (xcr0 & 0xE6) == 0xE6)
+			return LaneInstructionSet::AVX512;
+		if (avx2 && (xcr0 & 0x6) == 0x6)
+			return LaneInstructionSet::AVX2;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return LaneInstructionSet::AVX512;
+		if (__builtin_cpu_supports("avx2"))
+			return LaneInstructionSet::AVX2;
+#endif
+#endif
+		return LaneInstructionSet::Scalar;
+	}
+
+	LaneInstructionSet GetLaneInstructionSet()
+	{
+		static LaneInstructionSet instructionSet = DetectLaneInstructionSet();
+		return instructionSet;
+	}
+
+	std::string LaneInstructionSetToString(LaneInstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case LaneInstructionSet::Scalar: return "Scalar";
+		case LaneInstructionSet::AVX2: return "AVX2";
+		case LaneInstructionSet::AVX512: return "AVX512";
+		}
+
+		throw std::runtime_error("Unknown Lane Instruction Set in LaneInstructionSetToString!");
+		return "";
+	}
+
+	void InitializeLaneGroup(BruteForceLaneGroup& group, const BruteForceLaneParameters& params, const long long* deltas, int count)
+	{
+		group.DeltaCount = count;
+		group.FailureIterator = 0;
+		group.Done = params.TotalDurationToBeTransferred <= 0;
+		group.ActiveMask = group.Done ? 0 : (1u << BruteForceLaneGroup::c_LaneCount) - 1;
+
+		for (int lane = 0; lane < BruteForceLaneGroup::c_LaneCount; lane++)
+		{
+			group.Delta[lane] = (double)deltas[std::min(lane, count - 1)];
+			group.CollectionStart[lane] = 0;
+			group.TransferredTotalDuration[lane] = 0;
+			group.CollectionTime[lane] = 0;
+			group.WastedTime[lane] = 0;
+			group.ActualTotalDuration[lane] = 0;
+			group.FinalFailureIndex[lane] = -1;
+		}
+	}
+
+	void AdvanceLaneGroup(BruteForceLaneGroup& group, const FailureStream& failures, long long failureEnd,
+		const BruteForceLaneParameters& params, LaneInstructionSet instructionSet)
+	{
+		if (group.Done)
+			return;
+
+#if WSN_LANES_X86
+		if (instructionSet == LaneInstructionSet::AVX512)
+			AdvanceLanesAVX512(group, failures, failureEnd, params);
+		else if (instructionSet == LaneInstructionSet::AVX2)
+		{
+			AdvanceLanesAVX2(group, 0, failures, failureEnd, params);
+			AdvanceLanesAVX2(group, 4, failures, failureEnd, params);
+		}
+		else
+#endif
+			AdvanceLanesScalar(group, failures, failureEnd, params);
+
+		// a lane that is still active has walked up to failureEnd
+		if (group.ActiveMask == 0)
+			group.Done = true;
+		else
+			group.FailureIterator = failureEnd;
+	}
+
+	void GetLaneGroupResults(const BruteForceLaneGroup& group, BruteForceData* results)
+	{
+		for (int lane = 0; lane < group.DeltaCount; lane++)
+			results[lane] = { (long long)group.Delta[lane], (long long)group.CollectionTime[lane], (long long)group.WastedTime[lane],
+				(long long)group.ActualTotalDuration[lane], (long long)group.FinalFailureIndex[lane] };
+	}
+}
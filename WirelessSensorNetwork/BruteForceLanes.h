@@ -0,0 +1,66 @@
+#pragma once
+#include "Simulation.h"
+#include "FailureStream.h"
+
+namespace WSN
+{
+	struct BruteForceLaneParameters
+	{
+		long long TotalDurationToBeTransferred;
+		long long TransferTime;
+		long long RecoveryTime;
+	};
+
+	enum class LaneInstructionSet
+	{
+		Scalar,
+		AVX2,
+		AVX512
+	};
+
+	/// <summary>
+	/// Up to 8 deltas walking the same failure trace in lockstep, in SoA layout.
+	/// Every lane reads the same failure point at the same time, so each failure point is read once per group instead of once per delta.
+	/// Quantities are kept in doubles, which hold these integers exactly (well below 2^53).
+	/// </summary>
+	struct BruteForceLaneGroup
+	{
+		static constexpr int c_LaneCount = 8;
+
+		int DeltaCount = 0;
+		long long FailureIterator = 0;
+		bool Done = false;
+
+		// bit i set while lane i has not transferred everything yet
+		unsigned int ActiveMask = 0;
+
+		alignas(64) double Delta[c_LaneCount];
+		alignas(64) double CollectionStart[c_LaneCount]; // -1 while in Recovery
+		alignas(64) double TransferredTotalDuration[c_LaneCount];
+		alignas(64) double CollectionTime[c_LaneCount];
+		alignas(64) double WastedTime[c_LaneCount];
+		alignas(64) double ActualTotalDuration[c_LaneCount];
+		alignas(64) double FinalFailureIndex[c_LaneCount];
+	};
+
+	/// <summary>
+	/// Widest instruction set supported by both the build and the running CPU, detected once
+	/// </summary>
+	LaneInstructionSet GetLaneInstructionSet();
+
+	std::string LaneInstructionSetToString(LaneInstructionSet instructionSet);
+
+	/// <summary>
+	/// Fills a group with up to c_LaneCount deltas, the unused lanes repeat the last delta and are never reported
+	/// </summary>
+	void InitializeLaneGroup(BruteForceLaneGroup& group, const BruteForceLaneParameters& params, const long long* deltas, int count);
+
+	/// <summary>
+	/// Closed form brute force (see Simulation::AdvanceBruteForceClosedForm) of every lane, until they are
+	/// all done or need the failure point at failureEnd. failures must be prepared up to failureEnd.
+	/// </summary>
+	void AdvanceLaneGroup(BruteForceLaneGroup& group, const FailureStream& failures, long long failureEnd,
+		const BruteForceLaneParameters& params, LaneInstructionSet instructionSet);
+
+	void GetLaneGroupResults(const BruteForceLaneGroup& group, BruteForceData* results);
+}
@@ -0,0 +1,82 @@
+#include "WSNPCH.h"
+#include "CDF.h"
+
+namespace WSN
+{
+	std::vector<long long> GetCDFPoints(long long biggest, const CDFSettings& settings)
+	{
+		std::vector<long long> points;
+		const long long pointCount = std::max(settings.PointCount, 2LL);
+
+		switch (settings.Resolution)
+		{
+		case CDFResolution::PerSecond:
+			points.reserve(biggest + 1);
+			for (long long i = 0; i <= biggest; i++)
+				points.push_back(i);
+			break;
+		case CDFResolution::FixedBins:
+		{
+			const long long width = std::max((biggest + pointCount - 1) / pointCount, 1LL);
+			for (long long i = 0; i < biggest + width; i += width)
+				points.push_back(i);
+			break;
+		}
+		case CDFResolution::LogBins:
+			points.push_back(0);
+			for (long long i = 0; i < pointCount; i++)
+			{
+				long long point = std::llround(std::pow((double)std::max(biggest, 1LL), (double)i / (pointCount - 1)));
+				if (point > points.back())
+					points.push_back(point);
+			}
+			break;
+		case CDFResolution::Quantiles:
+			break;
+		}
+
+		return points;
+	}
+
+	std::vector<CDFPoint> EvaluateCDF(const std::vector<long long>& sorted, const std::vector<long long>& points)
+	{
+		std::vector<CDFPoint> cdf;
+		cdf.reserve(points.size());
+
+		size_t count = 0;
+		for (long long point : points)
+		{
+			while (count < sorted.size() && sorted[count] <= point)
+				count++;
+
+			cdf.push_back({ point, sorted.empty() ? 0.0 : count / (double)sorted.size() });
+		}
+
+		return cdf;
+	}
+
+	std::vector<CDFPoint> GetQuantileCDF(const std::vector<long long>& sorted, long long pointCount)
+	{
+		std::vector<CDFPoint> cdf;
+		if (sorted.empty())
+			return cdf;
+
+		const long long size = (long long)sorted.size();
+		pointCount = std::max(pointCount, 1LL);
+		cdf.reserve(std::min(pointCount, size));
+
+		for (long long i = 1; i <= pointCount; i++)
+		{
+			// smallest interval reaching the i-th quantile, reported with the exact CDF at that interval
+			long long index = std::max((i * size + pointCount - 1) / pointCount - 1, 0LL);
+			long long interval = sorted[index];
+			if (!cdf.empty() && cdf.back().Interval == interval)
+				continue;
+
+			long long count = std::upper_bound(sorted.begin() + index, sorted.end(), interval) - sorted.begin();
+			cdf.push_back({ interval, count / (double)size });
+		}
+
+		return cdf;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace WSN
+{
+	/// <summary>
+	/// PerSecond evaluates the CDF at every second up to the longest interval (one row per second).
+	/// FixedBins evaluates it every (longest interval / PointCount) seconds.
+	/// LogBins evaluates it at PointCount points spaced logarithmically up to the longest interval.
+	/// Quantiles evaluates it at the intervals reaching every 1 / PointCount of the sample.
+	/// </summary>
+	enum class CDFResolution
+	{
+		PerSecond,
+		FixedBins,
+		LogBins,
+		Quantiles
+	};
+
+	struct CDFSettings
+	{
+		CDFResolution Resolution = CDFResolution::FixedBins;
+		long long PointCount = 1000;
+	};
+
+	struct CDFPoint
+	{
+		long long Interval;
+		double Probability;
+	};
+
+	/// <summary>
+	/// Points shared by every sample whose longest interval is at most biggest, empty for Quantiles (see GetQuantileCDF)
+	/// </summary>
+	std::vector<long long> GetCDFPoints(long long biggest, const CDFSettings& settings);
+
+	/// <summary>
+	/// Empirical CDF of a sorted sample at increasing points, in a single pass over both
+	/// </summary>
+	std::vector<CDFPoint> EvaluateCDF(const std::vector<long long>& sorted, const std::vector<long long>& points);
+
+	/// <summary>
+	/// Empirical CDF of a sorted sample at its own pointCount quantiles
+	/// </summary>
+	std::vector<CDFPoint> GetQuantileCDF(const std::vector<long long>& sorted, long long pointCount);
+}
@@ -15,7 +15,6 @@ namespace WSN
 		static constexpr double x0 = 0.5;
 		static constexpr double step = 0.1;
 		static constexpr double maximumError = 0.00001;
-		static std::mt19937 Random(std::chrono::steady_clock::now().time_since_epoch().count());
 
 		double target = (mean * mean + stddev * stddev) / (mean * mean);
 
@@ -51,4 +50,139 @@ namespace WSN
 		Shape = NewtonsMethodWeibull(mean, stddev);
 		Scale = mean / tgammal(1 + 1 / Shape);
 	}
-}
\ No newline at end of file
+
+	// Acklam's rational approximation, refined with one Halley step
+	static double StandardNormalQuantile(double u)
+	{
+		static constexpr double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+		static constexpr double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+		static constexpr double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+		static constexpr double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+		static constexpr double low = 0.02425;
+
+		double x;
+		if (u < low)
+		{
+			double q = std::sqrt(-2 * std::log(u));
+			x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+		}
+		else if (u <= 1 - low)
+		{
+			double q = u - 0.5;
+			double r = q * q;
+			x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+		}
+		else
+		{
+			double q = std::sqrt(-2 * std::log1p(-u));
+			x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+		}
+
+		double e = 0.5 * std::erfc(-x / std::sqrt(2.0)) - u;
+		double g = e * std::sqrt(2 * 3.14159265358979323846) * std::exp(x * x / 2);
+		return x - g / (1 + x * g / 2);
+	}
+
+	// regularized lower incomplete gamma function P(shape, x)
+	static double RegularizedGammaP(double shape, double x)
+	{
+		static constexpr int maximumIterations = 1000;
+		static constexpr double epsilon = 1e-15;
+
+		if (x <= 0)
+			return 0;
+
+		double logPrefactor = shape * std::log(x) - x - std::lgamma(shape);
+
+		if (x < shape + 1)
+		{
+			// series
+			double term = 1 / shape;
+			double sum = term;
+			for (int n = 1; n < maximumIterations; n++)
+			{
+				term *= x / (shape + n);
+				sum += term;
+				if (std::abs(term) < std::abs(sum) * epsilon)
+					break;
+			}
+			return sum * std::exp(logPrefactor);
+		}
+
+		// continued fraction for Q, Lentz's method
+		static constexpr double tiny = 1e-300;
+		double b = x + 1 - shape;
+		double c = 1 / tiny;
+		double d = 1 / b;
+		double h = d;
+		for (int n = 1; n < maximumIterations; n++)
+		{
+			double an = -n * (n - shape);
+			b += 2;
+			d = an * d + b;
+			if (std::abs(d) < tiny)
+				d = tiny;
+			c = b + an / c;
+			if (std::abs(c) < tiny)
+				c = tiny;
+			d = 1 / d;
+			double delta = d * c;
+			h *= delta;
+			if (std::abs(delta - 1) < epsilon)
+				break;
+		}
+		return 1 - std::exp(logPrefactor) * h;
+	}
+
+	double Quantile(const std::weibull_distribution<double>& distribution, double u)
+	{
+		return distribution.b() * std::pow(-std::log1p(-u), 1 / distribution.a());
+	}
+
+	double Quantile(const std::gamma_distribution<double>& distribution, double u)
+	{
+		static constexpr int maximumIterations = 100;
+		static constexpr double maximumError = 1e-12;
+
+		const double shape = distribution.alpha();
+
+		// Wilson-Hilferty as the starting point, then Newton steps kept inside a shrinking bracket
+		double z = StandardNormalQuantile(u);
+		double t = 1 - 1 / (9 * shape) + z / (3 * std::sqrt(shape));
+		double x = shape * t * t * t;
+		if (!(x > 0))
+			x = std::pow(u * shape * std::tgamma(shape), 1 / shape);
+
+		double low = 0;
+		double high = std::numeric_limits<double>::infinity();
+		const double logGammaShape = std::lgamma(shape);
+
+		for (int i = 0; i < maximumIterations; i++)
+		{
+			double error = RegularizedGammaP(shape, x) - u;
+			if (error < 0)
+				low = x;
+			else
+				high = x;
+
+			double density = std::exp((shape - 1) * std::log(x) - x - logGammaShape);
+			double next = x - error / density;
+			if (!(next > low && next < high))
+				next = std::isinf(high) ? 2 * x : (low + high) / 2;
+
+			if (std::abs(next - x) <= maximumError * x)
+			{
+				x = next;
+				break;
+			}
+			x = next;
+		}
+
+		return x * distribution.beta();
+	}
+
+	double Quantile(const std::lognormal_distribution<double>& distribution, double u)
+	{
+		return std::exp(distribution.m() + distribution.s() * StandardNormalQuantile(u));
+	}
+}
@@ -23,4 +23,11 @@ namespace WSN
 		double Shape; // k
 		double Scale; // lambda
 	};
-}
\ No newline at end of file
+
+	/// <summary>
+	/// Inverse CDFs, u in (0, 1). Used to drive every distribution with the same uniform stream.
+	/// </summary>
+	double Quantile(const std::weibull_distribution<double>& distribution, double u);
+	double Quantile(const std::gamma_distribution<double>& distribution, double u);
+	double Quantile(const std::lognormal_distribution<double>& distribution, double u);
+}
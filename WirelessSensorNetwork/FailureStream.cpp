@@ -0,0 +1,56 @@
+#include "WSNPCH.h"
+#include "FailureStream.h"
+
+namespace WSN
+{
+	static_assert((FailureStream::c_WindowSize & (FailureStream::c_WindowSize - 1)) == 0, "The failure window size has to be a power of two!");
+
+	FailureStream::FailureStream(uint64_t seed, uint64_t stream, Sampler sampler, long long horizon)
+		: m_Random(seed, stream), m_Sampler(std::move(sampler)), m_Horizon(horizon), m_Buffer(c_WindowSize), m_Intervals(c_ChunkSize)
+	{
+	}
+
+	void FailureStream::GenerateChunk()
+	{
+		m_Sampler(m_Random, m_Intervals.data(), c_ChunkSize);
+
+		for (long long i = 0; i < c_ChunkSize; i++)
+		{
+			// same as generating until the horizon is reached : the last failure point is the first one at or past it
+			if (m_GeneratedEnd > 0 && m_LastFailurePoint >= m_Horizon)
+			{
+				m_Exhausted = true;
+				return;
+			}
+
+			m_LastFailurePoint += m_Intervals[i];
+			m_Buffer[m_GeneratedEnd & (c_WindowSize - 1)] = m_LastFailurePoint;
+			m_GeneratedEnd++;
+		}
+	}
+
+	void FailureStream::Prepare(long long index)
+	{
+		while (!m_Exhausted && m_GeneratedEnd <= index)
+			GenerateChunk();
+	}
+
+	long long FailureStream::At(long long index)
+	{
+		Prepare(index);
+
+		if (!Has(index))
+			throw std::runtime_error("Exceeded the last failure point!");
+
+		if (index < m_GeneratedEnd - c_WindowSize)
+			throw std::runtime_error("Failure point " + std::to_string(index) + " is no longer inside the failure stream window!");
+
+		return (*this)[index];
+	}
+
+	long long FailureStream::GetInterval(long long index)
+	{
+		long long current = At(index);
+		return index == 0 ? current : current - At(index - 1);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Philox.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Failure timestamps generated on demand, chunk by chunk, into a fixed size ring buffer.
+	/// Every FailureStream built with the same seed, stream and sampler yields the same failure points,
+	/// so any number of readers can replay a trace without keeping it in memory.
+	/// Only the last c_WindowSize failure points stay readable.
+	/// </summary>
+	class FailureStream
+	{
+	public:
+		// fills the buffer with strictly positive failure intervals
+		using Sampler = std::function<void(Philox& random, long long* intervals, long long count)>;
+
+		static constexpr long long c_ChunkSize = 4096;
+		static constexpr long long c_WindowSize = 2 * c_ChunkSize;
+
+		/// <param name="seed">Master seed of the failure interval generator</param>
+		/// <param name="stream">Philox stream of the failure intervals (see GetSubstream)</param>
+		/// <param name="sampler">Failure interval generator</param>
+		/// <param name="horizon">No failure point is generated after the first one at or past the horizon</param>
+		FailureStream(uint64_t seed, uint64_t stream, Sampler sampler, long long horizon);
+
+		/// <summary>
+		/// Generates the failure points up to index (inclusive), or up to the horizon, whichever comes first.
+		/// Failure points from index - c_ChunkSize onwards stay readable.
+		/// </summary>
+		void Prepare(long long index);
+
+		/// <summary>
+		/// True if failure point index exists, false if it lies past the horizon. Only valid for indices up to the last Prepare().
+		/// </summary>
+		inline bool Has(long long index) const { return index < m_GeneratedEnd; }
+
+		/// <summary>
+		/// Reads a failure point that is already generated and still inside the window
+		/// </summary>
+		inline long long operator[](long long index) const { return m_Buffer[index & (c_WindowSize - 1)]; }
+
+		/// <summary>
+		/// Sequential access : generates as needed, throws past the horizon or behind the window
+		/// </summary>
+		long long At(long long index);
+
+		/// <summary>
+		/// Failure point index - failure point (index - 1), the first interval starts at 0
+		/// </summary>
+		long long GetInterval(long long index);
+
+	private:
+		void GenerateChunk();
+
+		Philox m_Random;
+		Sampler m_Sampler;
+		long long m_Horizon;
+
+		std::vector<long long> m_Buffer;
+		std::vector<long long> m_Intervals;
+
+		long long m_GeneratedEnd = 0;
+		long long m_LastFailurePoint = 0;
+		bool m_Exhausted = false;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "DistributionParameters.h"
 #include "Simulation.h"
+#include "Sweep.h"
 
 
 static constexpr int s_TotalDurationToBeTransferred = 3600 * 24 * 90;
@@ -11,36 +12,70 @@ static constexpr int s_RecoveryTime = 30;
 static constexpr int s_RedoFirstIndex = 1;
 static constexpr int s_RedoLastIndex = 1;
 
-int main()
-{
+// true ignores s_RedoLastIndex : every grid point runs redos from s_RedoFirstIndex on until the 95% confidence
+// half-width of its DeltaStar and WastedTimeStar falls below the relative tolerance, or the maximum count is reached
+static constexpr bool s_StopOnConfidence = false;
+// min redos, max redos, relative tolerance
+static constexpr WSN::StoppingRule s_StoppingRule = { 3, 50, 0.01 };
 
-	for (int redo = s_RedoFirstIndex; redo <= s_RedoLastIndex; redo++)
-	{
-		for (int meanMultiplier = 1; meanMultiplier <= 8; meanMultiplier *= 8)
-		{
-			for (int stddev = 900; stddev <= 7200; stddev += 900)
-			{
-				std::cout << "Starting :\t Redo : " << redo << ",\t Standard Deviation : " << stddev * meanMultiplier << ",\t Mean : " << 3600 * meanMultiplier << '\n';
-				int currentMean = 3600 * meanMultiplier;
-				// totalDurationToBeTransferred, transferTime, recoveryTime, mean, stddev, redo
-				WSN::Simulation* Si = new WSN::Simulation(s_TotalDurationToBeTransferred, s_TransferTime, s_RecoveryTime, currentMean, stddev * meanMultiplier, redo);
+// true evaluates and logs every delta in the brute force range (needed for the figures),
+// false only searches for DeltaStar around DeltaOpt
+static constexpr bool s_ExhaustiveBruteForce = true;
 
+// CommonRandomNumbers drives the Weibull, Gamma and Lognormal traces of a simulation with the same uniforms,
+// s_Antithetic pairs redos s_RedoFirstIndex + 2k and s_RedoFirstIndex + 2k + 1 (1 - u instead of u), both make the averaged diffs settle with fewer redos
+static constexpr WSN::FailureSampling s_FailureSampling = WSN::FailureSampling::Independent;
+static constexpr bool s_Antithetic = false;
 
-				Si->SimulateAll();
+static_assert(!s_Antithetic || s_StopOnConfidence || (s_RedoLastIndex - s_RedoFirstIndex) % 2 == 1, "Antithetic redos come in pairs, the redo count has to be even!");
 
-				// start delta, end delta, delta step
-				Si->BruteForceAll(1, 3 * Si->GetDeltaOpt(), 1);
+// Full records every simulation interval into Results/RedoX/SimulationTrace*.bin, Sampled only one out of every 64
+static constexpr WSN::TraceMode s_TraceMode = WSN::TraceMode::Off;
+// converts the binary traces to Chrome trace JSON and CSV right away, they can also be converted later on
+static constexpr bool s_ExportTraces = false;
 
-				Si->Summarize();
-				Si->LogCDF();
+// master seed of the sweep, 0 draws one from the clock. The seed of every run is written to Results/Seed.txt,
+// setting it here reproduces that run
+static constexpr uint64_t s_Seed = 0;
 
-				delete Si;
-				WSN::Simulation::LogSummary();
-			}
+// PerSecond writes one CDF row per second up to the longest failure interval, which gets huge with lognormal failures
+static constexpr WSN::CDFSettings s_CDFSettings = { WSN::CDFResolution::FixedBins, 1000 };
+
+int main()
+{
+	std::vector<WSN::SweepPoint> points;
+	for (int redo = s_RedoFirstIndex; redo <= (s_StopOnConfidence ? s_RedoFirstIndex : s_RedoLastIndex); redo++)
+	{
+		for (int meanMultiplier = 1; meanMultiplier <= 8; meanMultiplier *= 8)
+		{
+			for (int stddev = 900; stddev <= 7200; stddev += 900)
+				points.push_back({ redo, 3600 * meanMultiplier, stddev * meanMultiplier });
 		}
 	}
 
-	WSN::Simulation::AverageAllRedos(s_RedoFirstIndex, s_RedoLastIndex);
+	WSN::SweepSettings settings;
+	settings.TotalDurationToBeTransferred = s_TotalDurationToBeTransferred;
+	settings.TransferTime = s_TransferTime;
+	settings.RecoveryTime = s_RecoveryTime;
+	settings.Engine = WSN::BruteForceEngine::ClosedFormLanes;
+	settings.Search = s_ExhaustiveBruteForce ? WSN::BruteForceSearch::Exhaustive : WSN::BruteForceSearch::Adaptive;
+	settings.TraceMode = s_TraceMode;
+	settings.ExportTraces = s_ExportTraces;
+	settings.CDFSettings = s_CDFSettings;
+	settings.Sampling = s_FailureSampling;
+	settings.Antithetic = s_Antithetic;
+	settings.FirstRedo = s_RedoFirstIndex;
+	settings.Seed = s_Seed != 0 ? s_Seed : std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+	// the grid points are independent, they run side by side on the shared thread pool
+	WSN::SweepExecutor executor(settings);
+	long long redoLastIndex = s_RedoLastIndex;
+	if (s_StopOnConfidence)
+		redoLastIndex = executor.RunUntilConverged(points, s_StoppingRule);
+	else
+		executor.Run(points);
+
+	WSN::Simulation::AverageAllRedos(s_RedoFirstIndex, redoLastIndex, s_Antithetic);
 
 	return 0;
-}
\ No newline at end of file
+}
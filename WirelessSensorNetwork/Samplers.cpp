@@ -0,0 +1,167 @@
+#include "WSNPCH.h"
+#include "Samplers.h"
+
+namespace WSN
+{
+	static constexpr int c_ZigguratLayers = 256;
+
+	/// <summary>
+	/// Layer i covers [0, X[i]] x [F[i], F[i + 1]], all of them with the same area.
+	/// Layer 0 is the base : the rectangle under f(r) and the tail past r, as a rectangle of width X[0].
+	/// </summary>
+	struct ZigguratTable
+	{
+		double X[c_ZigguratLayers + 1];
+		double F[c_ZigguratLayers + 1];
+	};
+
+	// r is where the tail starts, v the area of every layer, f the unnormalized density and inverse its inverse
+	template<typename Density, typename Inverse>
+	static ZigguratTable BuildZigguratTable(double r, double v, Density f, Inverse inverse)
+	{
+		ZigguratTable table;
+		table.X[0] = v / f(r);
+		table.X[1] = r;
+		for (int i = 1; i < c_ZigguratLayers - 1; i++)
+			table.X[i + 1] = inverse(std::min(f(table.X[i]) + v / table.X[i], 1.0));
+		table.X[c_ZigguratLayers] = 0;
+
+		for (int i = 0; i <= c_ZigguratLayers; i++)
+			table.F[i] = f(table.X[i]);
+
+		return table;
+	}
+
+	static const ZigguratTable s_ExponentialTable = BuildZigguratTable(7.69711747013104972, 0.0039496598225815571993,
+		[](double x) { return std::exp(-x); }, [](double y) { return -std::log(y); });
+
+	static const ZigguratTable s_NormalTable = BuildZigguratTable(3.6541528853610088, 0.00492867323399,
+		[](double x) { return std::exp(-0.5 * x * x); }, [](double y) { return std::sqrt(-2 * std::log(y)); });
+
+	// (k + 0.5) / 2^53, strictly inside (0, 1) so that its log is finite
+	static inline double OpenUniform(Philox& random)
+	{
+		return ((random() >> 11) + 0.5) * 0x1.0p-53;
+	}
+
+	double SampleExponential(Philox& random)
+	{
+		const ZigguratTable& table = s_ExponentialTable;
+		double tail = 0;
+
+		while (true)
+		{
+			// the low 8 bits pick the layer, the high 53 the position in it
+			uint64_t bits = random();
+			int i = bits & (c_ZigguratLayers - 1);
+			double x = (bits >> 11) * 0x1.0p-53 * table.X[i];
+
+			if (x < table.X[i + 1])
+				return tail + x;
+
+			if (i == 0)
+			{
+				// the exponential is memoryless, past r it starts over shifted by r
+				tail += table.X[1];
+				continue;
+			}
+
+			if (table.F[i] + OpenUniform(random) * (table.F[i + 1] - table.F[i]) < std::exp(-x))
+				return tail + x;
+		}
+	}
+
+	double SampleNormal(Philox& random)
+	{
+		const ZigguratTable& table = s_NormalTable;
+
+		while (true)
+		{
+			// the low 8 bits pick the layer, bit 8 the sign and the high 53 the position in the layer
+			uint64_t bits = random();
+			int i = bits & (c_ZigguratLayers - 1);
+			double sign = bits & c_ZigguratLayers ? -1.0 : 1.0;
+			double x = (bits >> 11) * 0x1.0p-53 * table.X[i];
+
+			if (x < table.X[i + 1])
+				return sign * x;
+
+			if (i == 0)
+			{
+				const double r = table.X[1];
+				double tailX, tailY;
+				do
+				{
+					tailX = -std::log(OpenUniform(random)) / r;
+					tailY = -std::log(OpenUniform(random));
+				} while (2 * tailY < tailX * tailX);
+
+				return sign * (r + tailX);
+			}
+
+			if (table.F[i] + OpenUniform(random) * (table.F[i + 1] - table.F[i]) < std::exp(-0.5 * x * x))
+				return sign * x;
+		}
+	}
+
+	double SampleGamma(Philox& random, double shape)
+	{
+		if (shape < 1)
+			return SampleGamma(random, shape + 1) * std::pow(OpenUniform(random), 1 / shape);
+
+		const double d = shape - 1.0 / 3;
+		const double c = 1 / std::sqrt(9 * d);
+
+		while (true)
+		{
+			double x = SampleNormal(random);
+			double v = 1 + c * x;
+			if (v <= 0)
+				continue;
+
+			v = v * v * v;
+			double u = OpenUniform(random);
+			if (u < 1 - 0.0331 * (x * x) * (x * x) || std::log(u) < 0.5 * x * x + d * (1 - v + std::log(v)))
+				return d * v;
+		}
+	}
+
+	void SampleExponential(Philox& random, double rate, std::span<double> values)
+	{
+		const double scale = 1 / rate;
+		for (double& value : values)
+			value = SampleExponential(random) * scale;
+	}
+
+	void SampleNormal(Philox& random, double mean, double stddev, std::span<double> values)
+	{
+		for (double& value : values)
+			value = mean + stddev * SampleNormal(random);
+	}
+
+	void SampleLognormal(Philox& random, double m, double s, std::span<double> values)
+	{
+		for (double& value : values)
+			value = SampleNormal(random);
+
+		for (double& value : values)
+			value = std::exp(m + s * value);
+	}
+
+	void SampleGamma(Philox& random, double shape, double scale, std::span<double> values)
+	{
+		for (double& value : values)
+			value = SampleGamma(random, shape) * scale;
+	}
+
+	void SampleWeibull(Philox& random, double shape, double scale, std::span<double> values)
+	{
+		for (double& value : values)
+			value = OpenUniform(random);
+
+		// -log(u) has the distribution of -log(1 - u), the quantile is scale * (-log(1 - u))^(1 / shape)
+		const double inverseShape = 1 / shape;
+		for (double& value : values)
+			value = scale * std::exp(std::log(-std::log(value)) * inverseShape);
+	}
+}
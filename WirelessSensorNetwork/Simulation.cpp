@@ -1,37 +1,17 @@
 #include "WSNPCH.h"
 #include "Simulation.h"
+#include "ThreadPool.h"
+#include "BruteForceLanes.h"
+#include "FailureStream.h"
+#include "TraceRecorder.h"
+#include "SummaryStore.h"
+#include "StateMachineKernel.h"
+#include "Samplers.h"
 
 
 namespace WSN
 {
 
-	static std::string SimulationIntervalToJsonString(SimulationInterval si, long long pid)
-	{
-		std::string name;
-		switch (si.State)
-		{
-		case State::Collection: name = "Collection"; break;
-		case State::Transfer: name = "Transfer"; break;
-		case State::Recovery: name = "Recovery"; break;
-		}
-
-		return "{ \"cat\" : \"Node\", \"pid\" :" + std::to_string(pid) + ",\"tid\" :" + std::to_string(pid) 
-			+ ",\"dur\" :" + std::to_string((si.EndTime - si.StartTime) * 1000000) + ",\"ts\" :" + std::to_string(si.StartTime * 1000000)
-			+ ",\"ph\" : \"X\",\"name\" :\"" + name + "\"}";
-	}
-
-	static std::string GetModeString(State s)
-	{
-		switch (s)
-		{
-		case State::Transfer: return "Transfer";
-		case State::Collection: return "Collection";
-		case State::Recovery: return "Recovery";
-		}
-
-		return "";
-	}
-
 	static std::tuple<long long, long long, long long, long long, long long> FindDeltaStar(const std::vector<BruteForceData>& maData)
 	{
 		long long bestDelta = maData[0].Delta;
@@ -55,9 +35,8 @@ namespace WSN
 		return { bestDelta, bestCT, bestWT, bestTotalDuration, bestFinalFailureIndex };
 	}
 
-	std::vector<SimulationSummaryData> Simulation::s_Summary;
-
-	Simulation::Simulation(long long totalDurationToBeTransferred, long long transferTime, long long recoveryTime, long long mean, long long stddev, long long redo)
+	Simulation::Simulation(long long totalDurationToBeTransferred, long long transferTime, long long recoveryTime, long long mean, long long stddev, long long redo,
+		uint64_t seed, const StreamKey& streamKey, FailureSampling sampling, bool antithetic, bool flipUniforms)
 		: m_WeibullParams(mean, stddev), m_LognormalParams(mean, stddev), m_GammaParams(mean, stddev)
 	{
 		m_SummaryData =
@@ -71,22 +50,18 @@ namespace WSN
 		};
 		m_SummaryData.RedoCount = redo;
 
-		std::cout << "Weibull K = " << m_WeibullParams.Shape << ", Weibull Lambda = " << m_WeibullParams.Scale
+		// built first and written at once, so that simulations running side by side don't interleave their lines
+		std::ostringstream parameters;
+		parameters << "Weibull K = " << m_WeibullParams.Shape << ", Weibull Lambda = " << m_WeibullParams.Scale
 			<< ", Gamma K = " << m_GammaParams.Shape << ", Gamma Theta = " << m_GammaParams.Scale
 			<< ", Lognormal Mu = " << m_LognormalParams.M << ", Lognormal Sigma = " << m_LognormalParams.S
 			<< "\n\n";
+		std::cout << parameters.str();
 		m_Weibull = Distribution<std::weibull_distribution<double>>(m_WeibullParams.Shape, m_WeibullParams.Scale);
 		m_Gamma = Distribution<std::gamma_distribution<double>>(m_GammaParams.Shape, m_GammaParams.Scale);
 		m_Lognormal = Distribution<std::lognormal_distribution<double>>(m_LognormalParams.M, m_LognormalParams.S);
 
-		if (!std::filesystem::is_directory("Results") || !std::filesystem::exists("Results"))
-			std::filesystem::create_directory("Results");
-
-
-		if (!std::filesystem::is_directory("Results/Redo" + std::to_string(m_SummaryData.RedoCount)) || !std::filesystem::exists("Results/Redo" + std::to_string(m_SummaryData.RedoCount)))
-			std::filesystem::create_directory("Results/Redo" + std::to_string(m_SummaryData.RedoCount));
-
-		m_Random = std::mt19937_64(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		std::filesystem::create_directories("Results/Redo" + std::to_string(m_SummaryData.RedoCount));
 
 		"Results/Redo" + std::to_string(m_SummaryData.RedoCount) + "/SimulationM" + std::to_string(m_SummaryData.Mean) + 'S' + std::to_string(m_SummaryData.StdDev)
 			+ "DUR" + std::to_string(m_SummaryData.TotalDurationToBeTransferred) + 'T' + std::to_string(m_SummaryData.TransferTime) + 'R' + std::to_string(m_SummaryData.RecoveryTime) + ".csv";
@@ -94,123 +69,72 @@ namespace WSN
 
 		static constexpr double failGenerationDurationMultiplier = 100.0;
 
-		// std::cout << "Weibull : ";
-		m_Weibull.GenerateFailures(m_Random, failGenerationDurationMultiplier * totalDurationToBeTransferred);
-		// std::cout << "Gamma : ";
-		m_Gamma.GenerateFailures(m_Random, failGenerationDurationMultiplier * totalDurationToBeTransferred);
-		// std::cout << "Lognormal : ";
-		m_Lognormal.GenerateFailures(m_Random, failGenerationDurationMultiplier * totalDurationToBeTransferred);
+		const long long failureHorizon = failGenerationDurationMultiplier * totalDurationToBeTransferred;
+
+		// both redos of an antithetic pair need the inverse CDF, so that u and 1 - u go through the same transform
+		const bool inverseSampling = sampling == FailureSampling::CommonRandomNumbers || antithetic;
+
+		// node 0 is the stream shared by every distribution, nodes 1 to 3 their own ones
+		auto getStream = [&](uint64_t node)
+		{
+			StreamKey key = streamKey;
+			key.Node = sampling == FailureSampling::CommonRandomNumbers ? 0 : node;
+			key.Purpose = RandomPurpose::Failures;
+			return GetSubstream(key);
+		};
+
+		m_Weibull.InitializeFailures(seed, getStream(1), failureHorizon, inverseSampling, flipUniforms);
+		m_Gamma.InitializeFailures(seed, getStream(2), failureHorizon, inverseSampling, flipUniforms);
+		m_Lognormal.InitializeFailures(seed, getStream(3), failureHorizon, inverseSampling, flipUniforms);
 	}
 
 
 
 	template<typename T>
-	SimulationData Simulation::SimulateSpecific(T& distribution)
+	SimulationData Simulation::SimulateSpecific(T& distribution, TraceRecorder& trace, int pid)
 	{
-		SimulationData simulationData;
-		simulationData.BruteForceData.Delta = m_SummaryData.DeltaOpt;
-		simulationData.BruteForceData.CollectionTime = 0;
-		long long currentTime = 0;
-		long long nextFailureTime = distribution.m_FailurePoints[0];
-		long long failureIterator = 0;
-		bool failed = false;
-		long long transferredTotalDuration = 0;
+		BruteForceProgress progress;
+		progress.Data.Delta = m_SummaryData.DeltaOpt;
+		FailureStream failures = distribution.GetFailures();
 
-		State currentState = State::Collection;
+		const StateMachineParameters params = { m_SummaryData.TotalDurationToBeTransferred, m_SummaryData.TransferTime, m_SummaryData.RecoveryTime };
+		RecorderTrace recorderTrace = { trace, pid };
+		NoTrace noTrace;
 
-		while (transferredTotalDuration < m_SummaryData.TotalDurationToBeTransferred)
+		for (long long failureEnd = FailureStream::c_ChunkSize; !progress.Done; failureEnd += FailureStream::c_ChunkSize)
 		{
-			if (failed)
-			{
-				failureIterator++;
-				if (failureIterator < distribution.m_FailurePoints.size())
-					nextFailureTime = distribution.m_FailurePoints[failureIterator];
-				else
-					throw std::runtime_error("Exceeded the last failure point!");;
+			failures.Prepare(failureEnd);
 
-				failed = false;
-			}
-
-			if (currentState == State::Collection)
-			{
-				long long nextTime = currentTime + m_SummaryData.DeltaOpt;
-				if (nextTime > nextFailureTime)
-				{
-					failed = true;
-					simulationData.SimulationIntervals.push_back({ State::Collection, currentTime, nextFailureTime });
-					currentState = State::Recovery;
-					simulationData.BruteForceData.WastedTime += nextFailureTime - currentTime;
-					currentTime = nextFailureTime;
-				}
-				else
-				{
-					simulationData.SimulationIntervals.push_back({ State::Collection, currentTime, nextTime });
-					currentState = State::Transfer;
-					currentTime = nextTime;
-					simulationData.BruteForceData.CollectionTime += m_SummaryData.DeltaOpt;
-				}
-			}
-			else if (currentState == State::Transfer)
-			{
-				long long nextTime = currentTime + m_SummaryData.TransferTime;
-				if (nextTime > nextFailureTime)
-				{
-					failed = true;
-					simulationData.SimulationIntervals.push_back({ State::Transfer, currentTime, nextFailureTime });
-					currentState = State::Recovery;
-
-					double proportionSent = (double)(nextFailureTime - currentTime) / m_SummaryData.TransferTime;
-					simulationData.BruteForceData.WastedTime += m_SummaryData.DeltaOpt + nextFailureTime - currentTime;
-					currentTime = nextFailureTime;
-					simulationData.BruteForceData.CollectionTime -= m_SummaryData.DeltaOpt;
-				}
-				else
-				{
-					simulationData.SimulationIntervals.push_back({ State::Transfer, currentTime, nextTime });
-					currentState = State::Collection;
-					currentTime = nextTime;
-					simulationData.BruteForceData.WastedTime += m_SummaryData.TransferTime;
-					transferredTotalDuration += m_SummaryData.DeltaOpt;
-				}
-			}
+			if (trace.IsEnabled())
+				AdvanceStateMachine<long long, WastedTimeAccounting>(progress, failures, failureEnd, params, recorderTrace);
 			else
-			{
-				long long nextTime = currentTime + m_SummaryData.RecoveryTime;
-				if (nextTime > nextFailureTime)
-				{
-					failed = true;
-					simulationData.SimulationIntervals.push_back({ State::Recovery, currentTime, nextFailureTime });
-					currentState = State::Recovery;
-					simulationData.BruteForceData.WastedTime += nextFailureTime - currentTime;
-					currentTime = nextFailureTime;
-				}
-				else
-				{
-					simulationData.SimulationIntervals.push_back({ State::Recovery, currentTime, nextTime });
-					currentState = State::Collection;
-					currentTime = nextTime;
-					simulationData.BruteForceData.WastedTime += m_SummaryData.RecoveryTime;
-				}
-			}
-
+				AdvanceStateMachine<long long, WastedTimeAccounting>(progress, failures, failureEnd, params, noTrace);
 		}
-		simulationData.BruteForceData.ActualTotalDuration = currentTime;
-		simulationData.BruteForceData.FinalFailureIndex = failureIterator - 1;
-
-		//std::cout << "Last Failure Index = " << failureIterator << '\n';
-		//simulationData.BruteForceData.WastedTime = simulationData.SimulationIntervals.back().EndTime - simulationData.BruteForceData.CollectionTime;
 
+		SimulationData simulationData;
+		simulationData.BruteForceData = progress.Data;
 		return simulationData;
 	}
 
 
 
-	void Simulation::SimulateAll()
+	std::string Simulation::GetResultFilePath(const std::string& name, const std::string& extension) const
+	{
+		return "Results/Redo" + std::to_string(m_SummaryData.RedoCount) + '/' + name + 'M' + std::to_string(m_SummaryData.Mean) + 'S' + std::to_string(m_SummaryData.StdDev)
+			+ "DUR" + std::to_string(m_SummaryData.TotalDurationToBeTransferred) + 'T' + std::to_string(m_SummaryData.TransferTime) + 'R' + std::to_string(m_SummaryData.RecoveryTime) + extension;
+	}
+
+	void Simulation::SimulateAll(TraceMode traceMode)
 	{
+		SimulationData DataWeibull, DataGamma, DataLognormal;
 
-		SimulationData DataWeibull = SimulateSpecific(m_Weibull);
-		SimulationData DataGamma = SimulateSpecific(m_Gamma);
-		SimulationData DataLognormal = SimulateSpecific(m_Lognormal);
+		{
+			TraceRecorder trace(GetResultFilePath("SimulationTrace", ".bin"), traceMode);
+
+			DataWeibull = SimulateSpecific(m_Weibull, trace, 1);
+			DataGamma = SimulateSpecific(m_Gamma, trace, 2);
+			DataLognormal = SimulateSpecific(m_Lognormal, trace, 3);
+		}
 
 		m_SummaryData.CollectionTimeWeibull = DataWeibull.BruteForceData.CollectionTime;
 		m_SummaryData.CollectionTimeGamma = DataGamma.BruteForceData.CollectionTime;
@@ -229,168 +153,265 @@ namespace WSN
 		m_SummaryData.FinalFailureIndexLognormal = DataLognormal.BruteForceData.FinalFailureIndex;
 
 
-		std::string baseFilePath = "Results/Redo" + std::to_string(m_SummaryData.RedoCount) + "/SimulationM" + std::to_string(m_SummaryData.Mean) + 'S' + std::to_string(m_SummaryData.StdDev)
-			+ "DUR" + std::to_string(m_SummaryData.TotalDurationToBeTransferred) + 'T' + std::to_string(m_SummaryData.TransferTime) + 'R' + std::to_string(m_SummaryData.RecoveryTime) + ".csv";
-		std::ofstream OStream(baseFilePath);
-
-		std::ofstream StreamJson("Results/Redo" + std::to_string(m_SummaryData.RedoCount) + "/SimulationTraceM" + std::to_string(m_SummaryData.Mean) + 'S' + std::to_string(m_SummaryData.StdDev)
-			+ "DUR" + std::to_string(m_SummaryData.TotalDurationToBeTransferred) + 'T' + std::to_string(m_SummaryData.TransferTime) + 'R' + std::to_string(m_SummaryData.RecoveryTime) + ".json");
-		StreamJson << '[';
+		std::ofstream OStream(GetResultFilePath("Simulation", ".csv"));
 
 		OStream << "Delta,Collection Time,Wasted Time,Total Actual Duration,,Delta,Collection Time,Wasted Time,Total Actual Duration,,Delta,Collection Time,Wasted Time,Total Actual Duration\n" 
 			<< DataWeibull.BruteForceData.Delta << ',' << DataWeibull.BruteForceData.CollectionTime << ',' << DataWeibull.BruteForceData.WastedTime << ',' << DataWeibull.BruteForceData.ActualTotalDuration << ",,"
 			<< DataLognormal.BruteForceData.Delta << ',' << DataLognormal.BruteForceData.CollectionTime << ',' << DataLognormal.BruteForceData.WastedTime << ',' << DataLognormal.BruteForceData.ActualTotalDuration << ",,"
-			<< DataGamma.BruteForceData.Delta << ',' << DataGamma.BruteForceData.CollectionTime << ',' << DataGamma.BruteForceData.WastedTime << ',' << DataGamma.BruteForceData.ActualTotalDuration << "\n\n\n"
-			<< "State,Start Time,End Time,,,State,Start Time,End Time,,,State,Start Time,End Time\n";
+			<< DataGamma.BruteForceData.Delta << ',' << DataGamma.BruteForceData.CollectionTime << ',' << DataGamma.BruteForceData.WastedTime << ',' << DataGamma.BruteForceData.ActualTotalDuration << '\n';
+	}
 
+	void Simulation::ExportTrace()
+	{
+		const std::string tracePath = GetResultFilePath("SimulationTrace", ".bin");
 
-		int maxSize = std::max(std::max(DataWeibull.SimulationIntervals.size(), DataLognormal.SimulationIntervals.size()), DataGamma.SimulationIntervals.size());
+		TraceRecorder::ExportJson(tracePath, GetResultFilePath("SimulationTrace", ".json"));
+		TraceRecorder::ExportCsv(tracePath, GetResultFilePath("SimulationTrace", ".csv"));
+	}
 
-		for (int i = 0; i < maxSize; i++)
-		{
-			if (i < DataWeibull.SimulationIntervals.size())
-				OStream << GetModeString(DataWeibull.SimulationIntervals[i].State) << ',' << DataWeibull.SimulationIntervals[i].StartTime << ',' << DataWeibull.SimulationIntervals[i].EndTime << ",,,";
-			else
-				OStream << ",,,,,";
 
-			if (i < DataGamma.SimulationIntervals.size())
-				OStream << GetModeString(DataGamma.SimulationIntervals[i].State) << ',' << DataGamma.SimulationIntervals[i].StartTime << ',' << DataGamma.SimulationIntervals[i].EndTime << ",,,";
-			else
-				OStream << ",,,,,";
+	template<typename T>
+	std::vector<BruteForceData> Simulation::BruteForceSpecific(T& distribution, long long start, long long end, long long step, BruteForceEngine engine)
+	{
+		std::vector<long long> deltas;
+		for (long long i = start; i < end; i += step)
+			deltas.push_back(i);
 
-			if (i < DataLognormal.SimulationIntervals.size())
-				OStream << GetModeString(DataLognormal.SimulationIntervals[i].State) << ',' << DataLognormal.SimulationIntervals[i].StartTime << ',' << DataLognormal.SimulationIntervals[i].EndTime;
-			OStream << '\n';
-		}
+		return BruteForceDeltas(distribution, deltas, engine);
+	}
+
+	template<typename T>
+	std::vector<BruteForceData> Simulation::BruteForceAdaptive(T& distribution, long long start, long long end, long long step, BruteForceEngine engine)
+	{
+		static constexpr long long coarsePointCount = 64;
+		static constexpr long long refinementFactor = 4;
+		static constexpr int refinedCandidateCount = 5;
+
+		long long deltaCount = (end - start + step - 1) / step;
+		if (deltaCount <= coarsePointCount)
+			return BruteForceSpecific(distribution, start, end, step, engine);
 
+		// grid indices instead of deltas, delta = start + index * step
+		std::map<long long, BruteForceData> evaluated;
+		auto evaluate = [&](const std::vector<long long>& indices)
+		{
+			std::vector<long long> deltas;
+			for (long long index : indices)
+				if (index >= 0 && index < deltaCount && evaluated.find(index) == evaluated.end())
+					deltas.push_back(start + index * step);
 
-		for (int i = 0; i < DataWeibull.SimulationIntervals.size(); i++)
-			StreamJson << SimulationIntervalToJsonString(DataWeibull.SimulationIntervals[i], 1) << ",\n";
+			std::sort(deltas.begin(), deltas.end());
+			deltas.erase(std::unique(deltas.begin(), deltas.end()), deltas.end());
 
+			std::vector<BruteForceData> results = BruteForceDeltas(distribution, deltas, engine);
+			for (int i = 0; i < results.size(); i++)
+				evaluated[(deltas[i] - start) / step] = results[i];
+		};
 
-		for (int i = 0; i < DataGamma.SimulationIntervals.size(); i++)
-			StreamJson << SimulationIntervalToJsonString(DataGamma.SimulationIntervals[i], 2) << ",\n";
+		long long stride = deltaCount / coarsePointCount;
+		long long optIndex = std::clamp((m_SummaryData.DeltaOpt - start) / step, 0LL, deltaCount - 1);
 
+		std::vector<long long> indices;
+		for (long long index = optIndex % stride; index < deltaCount; index += stride)
+			indices.push_back(index);
+		evaluate(indices);
 
-		for (int i = 0; i < DataLognormal.SimulationIntervals.size(); i++)
+		while (stride > 1)
 		{
-			StreamJson << SimulationIntervalToJsonString(DataLognormal.SimulationIntervals[i], 3);
-			if (i != DataLognormal.SimulationIntervals.size() - 1)
-				StreamJson << ',';
-			StreamJson << '\n';
+			// the wasted time curve of a single failure trace is jagged, so a few of the best
+			// deltas are refined instead of trusting the neighbourhood of the very best one
+			std::vector<std::pair<long long, long long>> ranked;
+			for (auto& [index, bfData] : evaluated)
+				ranked.push_back({ bfData.WastedTime, index });
+			std::sort(ranked.begin(), ranked.end());
+
+			long long nextStride = std::max(stride / refinementFactor, 1LL);
+
+			indices.clear();
+			for (int i = 0; i < refinedCandidateCount && i < ranked.size(); i++)
+				for (long long index = ranked[i].second - stride; index <= ranked[i].second + stride; index += nextStride)
+					indices.push_back(index);
+			evaluate(indices);
+
+			stride = nextStride;
 		}
 
+		std::vector<BruteForceData> BFDatas;
+		for (auto& [index, bfData] : evaluated)
+			BFDatas.push_back(bfData);
 
-		StreamJson << ']';
-
+		return BFDatas;
 	}
 
-
 	template<typename T>
-	std::vector<BruteForceData> Simulation::BruteForceSpecific(T& distribution, long long start, long long end, long long step)
+	std::vector<BruteForceData> Simulation::BruteForceDeltas(T& distribution, const std::vector<long long>& deltas, BruteForceEngine engine)
 	{
-		std::vector<BruteForceData> BFDatas;
+		static constexpr long long deltasPerTask = 32;
 
-		for (int i = start; i < end; i += step)
-		{
-			BruteForceData bfData = { i, 0 };
+		// every task replays the failure trace once for all of its deltas, chunk by chunk,
+		// and writes into its own slots of the output
+		std::vector<BruteForceData> BFDatas(deltas.size());
+		long long taskCount = (deltas.size() + deltasPerTask - 1) / deltasPerTask;
 
-			bool done = false;
-			long long currentTime = 0;
-			bool failed = false;
-			long long failureIterator = 0;
-			long long nextFailureTime = distribution.m_FailurePoints[0];
-			long long transferredTotalDuration = 0;
+		ThreadPool::Get().ParallelFor(taskCount, [&](long long task)
+			{
+				long long first = task * deltasPerTask;
+				long long count = std::min<long long>(deltasPerTask, deltas.size() - first);
 
-			State currentState = State::Collection;
+				FailureStream failures = distribution.GetFailures();
 
-			while (transferredTotalDuration < m_SummaryData.TotalDurationToBeTransferred)
-			{
-				if (failed)
+				if (engine == BruteForceEngine::ClosedFormLanes)
 				{
-					failureIterator++;
-					if (failureIterator < distribution.m_FailurePoints.size())
-						nextFailureTime = distribution.m_FailurePoints[failureIterator];
-					else
-						throw std::runtime_error("Exceeded the last failure point!");
+					BruteForceLaneParameters params = { m_SummaryData.TotalDurationToBeTransferred, m_SummaryData.TransferTime, m_SummaryData.RecoveryTime };
+					LaneInstructionSet instructionSet = GetLaneInstructionSet();
 
+					std::vector<BruteForceLaneGroup> groups((count + BruteForceLaneGroup::c_LaneCount - 1) / BruteForceLaneGroup::c_LaneCount);
+					for (int i = 0; i < groups.size(); i++)
+						InitializeLaneGroup(groups[i], params, deltas.data() + first + i * BruteForceLaneGroup::c_LaneCount,
+							std::min<long long>(BruteForceLaneGroup::c_LaneCount, count - i * BruteForceLaneGroup::c_LaneCount));
 
-					
-					failed = false;
-				}
-
-				if (currentState == State::Collection)
-				{
-					long long nextTime = currentTime + i;
-					if (nextTime > nextFailureTime)
+					bool done = false;
+					for (long long failureEnd = FailureStream::c_ChunkSize; !done; failureEnd += FailureStream::c_ChunkSize)
 					{
-						failed = true;
-						currentState = State::Recovery;
-						bfData.WastedTime += nextFailureTime - currentTime;
-						currentTime = nextFailureTime;
-					}
-					else
-					{
-						currentState = State::Transfer;
-						currentTime = nextTime;
-						bfData.CollectionTime += i;
+						failures.Prepare(failureEnd);
+
+						done = true;
+						for (auto& group : groups)
+						{
+							AdvanceLaneGroup(group, failures, failureEnd, params, instructionSet);
+							done &= group.Done;
+						}
 					}
+
+					for (int i = 0; i < groups.size(); i++)
+						GetLaneGroupResults(groups[i], BFDatas.data() + first + i * BruteForceLaneGroup::c_LaneCount);
+
+					return;
 				}
-				else if (currentState == State::Transfer)
+
+				std::vector<BruteForceProgress> progress(count);
+				for (int i = 0; i < count; i++)
+					progress[i].Data.Delta = deltas[first + i];
+
+				bool done = false;
+				for (long long failureEnd = FailureStream::c_ChunkSize; !done; failureEnd += FailureStream::c_ChunkSize)
 				{
-					long long nextTime = currentTime + m_SummaryData.TransferTime;
-					if (nextTime > nextFailureTime)
-					{
-						failed = true;
-						currentState = State::Recovery;
-						double proportionSent = (double)(nextFailureTime - currentTime) / m_SummaryData.TransferTime;
-						bfData.WastedTime += i + nextFailureTime - currentTime;
-						currentTime = nextFailureTime;
-						bfData.CollectionTime -= i;
-					}
-					else
+					failures.Prepare(failureEnd);
+
+					done = true;
+					for (auto& deltaProgress : progress)
 					{
-						currentState = State::Collection;
-						currentTime = nextTime;
-						bfData.WastedTime += m_SummaryData.TransferTime;
-						transferredTotalDuration += i;
+						if (engine == BruteForceEngine::ClosedForm)
+							AdvanceBruteForceClosedForm(deltaProgress, failures, failureEnd);
+						else
+							AdvanceBruteForce(deltaProgress, failures, failureEnd);
+						done &= deltaProgress.Done;
 					}
 				}
-				else
+
+				for (int i = 0; i < count; i++)
+					BFDatas[first + i] = progress[i].Data;
+			});
+
+		return BFDatas;
+	}
+
+	void Simulation::AdvanceBruteForce(BruteForceProgress& progress, const FailureStream& failures, long long failureEnd) const
+	{
+		const StateMachineParameters params = { m_SummaryData.TotalDurationToBeTransferred, m_SummaryData.TransferTime, m_SummaryData.RecoveryTime };
+		NoTrace noTrace;
+		AdvanceStateMachine<long long, WastedTimeAccounting>(progress, failures, failureEnd, params, noTrace);
+	}
+
+	// Between two failures the state machine is periodic : starting in Collection at time s with the next failure at F,
+	// floor((F - s) / (delta + TransferTime)) cycles complete, and whatever is left of the interval is wasted,
+	// no matter if the failure hits during Collection or during Transfer (the collected delta is lost in the latter).
+	// The failure is then followed by Recovery, which is either cut short by the next failure or ends the interval.
+	// Failure points are the prefix sums of the failure intervals, so every interval length is a single subtraction.
+	void Simulation::AdvanceBruteForceClosedForm(BruteForceProgress& progress, const FailureStream& failures, long long failureEnd) const
+	{
+		if (progress.Done)
+			return;
+
+		const long long delta = progress.Data.Delta;
+		const long long cycleTime = delta + m_SummaryData.TransferTime;
+		BruteForceData& bfData = progress.Data;
+
+		while (progress.TransferredTotalDuration < m_SummaryData.TotalDurationToBeTransferred)
+		{
+			if (progress.FailureIterator >= failureEnd)
+				return;
+
+			if (!failures.Has(progress.FailureIterator))
+				throw std::runtime_error("Exceeded the last failure point!");
+
+			long long nextFailureTime = failures[progress.FailureIterator];
+
+			if (progress.CurrentState == State::Collection)
+			{
+				long long collectionStart = progress.CurrentTime;
+				long long completedCycles = (nextFailureTime - collectionStart) / cycleTime;
+				long long remainingCycles = (m_SummaryData.TotalDurationToBeTransferred - progress.TransferredTotalDuration + delta - 1) / delta;
+
+				if (remainingCycles <= completedCycles)
 				{
-					long long nextTime = currentTime + m_SummaryData.RecoveryTime;
-					if (nextTime > nextFailureTime)
-					{
-						failed = true;
-						currentState = State::Recovery;
-						bfData.WastedTime += nextFailureTime - currentTime;
-						currentTime = nextFailureTime;
-					}
-					else
-					{
-						currentState = State::Collection;
-						currentTime = nextTime;
-						bfData.WastedTime += m_SummaryData.RecoveryTime;
-					}
+					bfData.CollectionTime += remainingCycles * delta;
+					bfData.WastedTime += remainingCycles * m_SummaryData.TransferTime;
+					progress.TransferredTotalDuration += remainingCycles * delta;
+					progress.CurrentTime = collectionStart + remainingCycles * cycleTime;
+					break;
 				}
 
+				bfData.CollectionTime += completedCycles * delta;
+				bfData.WastedTime += completedCycles * m_SummaryData.TransferTime + (nextFailureTime - collectionStart - completedCycles * cycleTime);
+				progress.TransferredTotalDuration += completedCycles * delta;
+			}
+
+			// Recovery starts at the failure, and Collection restarts only if the next failure does not cut it short
+			long long recoveryStart = nextFailureTime;
+			progress.FailureIterator++;
+
+			if (!failures.Has(progress.FailureIterator))
+				throw std::runtime_error("Exceeded the last failure point!");
+
+			if (recoveryStart + m_SummaryData.RecoveryTime > failures[progress.FailureIterator])
+			{
+				bfData.WastedTime += failures[progress.FailureIterator] - recoveryStart;
+				progress.CurrentState = State::Recovery;
+				progress.CurrentTime = failures[progress.FailureIterator];
+			}
+			else
+			{
+				bfData.WastedTime += m_SummaryData.RecoveryTime;
+				progress.CurrentState = State::Collection;
+				progress.CurrentTime = recoveryStart + m_SummaryData.RecoveryTime;
 			}
-			// bfData.WastedTime = currentTime - bfData.CollectionTime;
-			// std::cout << "Last Failure Index = " << failureIterator << '\n';
-			bfData.ActualTotalDuration = currentTime;
-			bfData.FinalFailureIndex = failureIterator - 1;
-			BFDatas.push_back(bfData);
 		}
 
-		return BFDatas;
+		bfData.ActualTotalDuration = progress.CurrentTime;
+		bfData.FinalFailureIndex = progress.FailureIterator - 1;
+		progress.Done = true;
 	}
 
 
-	void Simulation::BruteForceAll(long long start, long long end, long long step)
+	void Simulation::BruteForceAll(long long start, long long end, long long step, BruteForceEngine engine, BruteForceSearch search)
 	{
-		std::vector<BruteForceData> bfDataWeibull = BruteForceSpecific(m_Weibull, start, end, step);
-		std::vector<BruteForceData> bfDataGamma = BruteForceSpecific(m_Gamma, start, end, step);
-		std::vector<BruteForceData> bfDataLognormal = BruteForceSpecific(m_Lognormal, start, end, step);
+		std::vector<BruteForceData> bfDataWeibull;
+		std::vector<BruteForceData> bfDataGamma;
+		std::vector<BruteForceData> bfDataLognormal;
+
+		if (search == BruteForceSearch::Adaptive)
+		{
+			bfDataWeibull = BruteForceAdaptive(m_Weibull, start, end, step, engine);
+			bfDataGamma = BruteForceAdaptive(m_Gamma, start, end, step, engine);
+			bfDataLognormal = BruteForceAdaptive(m_Lognormal, start, end, step, engine);
+		}
+		else
+		{
+			bfDataWeibull = BruteForceSpecific(m_Weibull, start, end, step, engine);
+			bfDataGamma = BruteForceSpecific(m_Gamma, start, end, step, engine);
+			bfDataLognormal = BruteForceSpecific(m_Lognormal, start, end, step, engine);
+		}
 
 		auto bfWeibullResults = FindDeltaStar(bfDataWeibull);
 		auto bfGammaResults = FindDeltaStar(bfDataGamma);
@@ -452,163 +473,26 @@ namespace WSN
 
 	}
 
-	void Simulation::Summarize()
+	void Simulation::Summarize(SummaryLog& log, long long order) const
 	{
-		s_Summary.push_back(m_SummaryData);
+		log.Add(order, m_SummaryData);
 	}
 
 
-	void Simulation::LogSummary()
-	{
-		
-		static std::vector<long long> redoLogged;
-
-		for (int i = 0; i < s_Summary.size(); i++)
-		{
-			auto& current = s_Summary[i];
-			std::string path = "Results/Redo" + std::to_string(current.RedoCount) + "/Summary.csv";
-
-			if (std::find(redoLogged.begin(), redoLogged.end(), current.RedoCount) == redoLogged.end())
-			{
-				redoLogged.push_back(current.RedoCount);
-				std::ofstream OStream(path);
-				OStream << "Mean,Standard Deviation,Total Duration To Be Transferred,Transfer Time,Recovery Time,Delta Optimal,Delta Star Weibull,Delta Star Gamma,Delta Star Lognormal,"
-					"Collection Time Weibull,Collection Time Gamma,Collection Time Lognormal,"
-					"Collection Time Star Weibull,Collection Time Star Gamma,Collection Time Star Lognormal,"
-					"Wasted Time Weibull,Wasted Time Gamma,Wasted Time Lognormal," //
-					"Wasted Time Star Weibull,Wasted Time Star Gamma,Wasted Time Star Lognormal," //
-					"Actual Total Duration Weibull,Actual Total Duration Gamma,Actual Total Duration Lognormal,"
-					"Actual Total Duration Star Weibull,Actual Total Duration Star Gamma,Actual Total Duration Star Lognormal,"
-					"Total Number Of Failures Weibull,Total Number Of Failures Gamma, Total Number Of Failures Lognormal,"
-					"Total Number Of Failures Star Weibull,Total Number Of Failures Star Gamma, Total Number Of Failures Star Lognormal," //;
-					"Redo,Diff Delta Weibull,Diff Delta Gamma,Diff Delta Lognormal,"
-					"Diff CT Weibull,Diff CT Gamma,Diff CT Lognormal,"
-					"Diff WT Weibull,Diff WT Gamma,Diff WT Lognormal\n";
-			}
-
-
-			// TO DO
-			// (opt - star) / star
-			double diffDeltaWeibull = (current.DeltaOpt - current.DeltaStarWeibull) / (double)current.DeltaStarWeibull;
-			double diffDeltaGamma = (current.DeltaOpt - current.DeltaStarGamma) / (double)current.DeltaStarGamma;
-			double diffDeltaLognormal = (current.DeltaOpt - current.DeltaStarLognormal) / (double)current.DeltaStarLognormal;
-
-			double diffCTWeibull = (current.CollectionTimeStarWeibull - current.CollectionTimeWeibull) / (double)current.CollectionTimeStarWeibull;
-			double diffCTGamma = (current.CollectionTimeStarGamma - current.CollectionTimeGamma) / (double)current.CollectionTimeStarGamma;
-			double diffCTLognormal = (current.CollectionTimeStarLognormal - current.CollectionTimeLognormal) / (double)current.CollectionTimeStarLognormal;
-
-
-			double diffWTWeibull = (current.WastedTimeWeibull - current.WastedTimeStarWeibull) / (double)current.WastedTimeStarWeibull;
-			double diffWTGamma = (current.WastedTimeGamma - current.WastedTimeStarGamma) / (double)current.WastedTimeStarGamma;
-			double diffWTLognormal = (current.WastedTimeLognormal - current.WastedTimeStarLognormal) / (double)current.WastedTimeStarLognormal;
-
-
-
-			std::ofstream OStream(path, std::fstream::app);
-			OStream << current.Mean << ',' << current.StdDev << ',' << current.TotalDurationToBeTransferred << ',' << current.TransferTime << ',' << current.RecoveryTime << ',' << current.DeltaOpt << ','
-				<< current.DeltaStarWeibull << ',' << current.DeltaStarGamma << ',' << current.DeltaStarLognormal << ','
-				<< current.CollectionTimeWeibull << ',' << current.CollectionTimeGamma << ',' << current.CollectionTimeLognormal << ',' 
-				<< current.CollectionTimeStarWeibull << ',' << current.CollectionTimeStarGamma << ',' << current.CollectionTimeStarLognormal << ',' 
-				<< current.WastedTimeWeibull << ',' << current.WastedTimeGamma << ',' << current.WastedTimeLognormal << ','
-				<< current.WastedTimeStarWeibull << ',' << current.WastedTimeStarGamma << ',' << current.WastedTimeStarLognormal << ','
-				<< current.ActualTotalDurationWeibull << ',' << current.ActualTotalDurationGamma << ',' << current.ActualTotalDurationLognormal << ','
-				<< current.ActualTotalDurationStarWeibull << ',' << current.ActualTotalDurationStarGamma << ',' << current.ActualTotalDurationStarLognormal << ','
-				<< current.FinalFailureIndexWeibull << ',' << current.FinalFailureIndexGamma << ',' << current.FinalFailureIndexLognormal << ','
-				<< current.FinalFailureIndexStarWeibull << ',' << current.FinalFailureIndexStarGamma << ',' << current.FinalFailureIndexStarLognormal << ','
-				<< current.RedoCount << ','
-				<< diffDeltaWeibull << ',' << diffDeltaGamma << ',' << diffDeltaLognormal << ',' 
-				<< diffCTWeibull << ',' << diffCTGamma << ',' << diffCTLognormal << ',' 
-				<< diffWTWeibull << ',' << diffWTGamma << ',' << diffWTLognormal << ',' 
-				<< '\n';
-
-		}
-
-		s_Summary.clear();
-
-	}
-
-	void Simulation::AverageAllRedos(int redoStart, int redoEnd)
+	void Simulation::AverageAllRedos(int redoStart, int redoEnd, bool antithetic)
 	{
-		std::vector<std::vector<std::vector<double>>> datas;
+		std::vector<SummaryStore> stores;
+		std::vector<long long> groups;
 		for (int r = redoStart; r <= redoEnd; r++)
 		{
-			datas.push_back({});
-			std::string path = "Results/Redo" + std::to_string(r) + "/Summary.csv";
-			std::ifstream summaryStream(path);
-			std::string temp;
-			std::getline(summaryStream, temp);
-
-			while (std::getline(summaryStream, temp))
-			{
-				datas.back().push_back({});
-				
-				int prevStart = 0;
-				for (int s = 0; s < temp.size(); s++)
-				{
-					if (temp[s] == ',' || s == temp.size() - 1)
-					{
-						double t = std::stod(temp.substr(prevStart, s - prevStart));
-						datas.back().back().push_back(t);
-						prevStart = s + 1;
-					}
-				}
-			}
+			stores.emplace_back(GetSummaryStorePath(r));
+			groups.push_back(antithetic ? (r - redoStart) / 2 : r);
 		}
 
+		const std::string redoName = std::to_string(redoStart) + "-" + std::to_string(redoEnd);
 
-		// DANGER ZONE !
-		// 33rd index column = redo
-		std::vector<std::vector<std::string>> averages(datas[0].size(), std::vector<std::string>(datas[0][0].size()));
-
-		for (int i = 0; i < datas[0].size(); i++)
-		{
-			for (int j = 0; j < datas[0][0].size(); j++)
-			{
-				if (j < 33)
-				{
-					double average = 0.0;
-					for (int k = 0; k < datas.size(); k++)
-						average += datas[k][i][j] / datas.size();
-
-					averages[i][j] = std::to_string(average);
-				}
-				else if (j == 33)
-					averages[i][j] = std::to_string(redoStart) + "-" + std::to_string(redoEnd);
-				else if (j < 37)
-					averages[i][j] = std::to_string((std::stod(averages[i][5]) - std::stod(averages[i][j - 28])) / std::stod(averages[i][j - 28]));
-				else if (j < 40)
-					averages[i][j] = std::to_string((std::stod(averages[i][j - 28]) - std::stod(averages[i][j - 25])) / std::stod(averages[i][j - 25]));
-				else if (j < 43)
-					averages[i][j] = std::to_string((std::stod(averages[i][j - 25]) - std::stod(averages[i][j - 22])) / std::stod(averages[i][j - 22]));
-
-			}
-		}
-
-		std::ofstream ostream("Results/AverageRedo" + std::to_string(redoStart) + '-' + std::to_string(redoEnd) + ".csv");
-		ostream << std::fixed << std::setprecision(5);
-		ostream << "Mean,Standard Deviation,Total Duration To Be Transferred,Transfer Time,Recovery Time,Delta Optimal,Delta Star Weibull,Delta Star Gamma,Delta Star Lognormal,"
-			"Collection Time Weibull,Collection Time Gamma,Collection Time Lognormal,"
-			"Collection Time Star Weibull,Collection Time Star Gamma,Collection Time Star Lognormal,"
-			"Wasted Time Weibull,Wasted Time Gamma,Wasted Time Lognormal," 
-			"Wasted Time Star Weibull,Wasted Time Star Gamma,Wasted Time Star Lognormal," 
-			"Actual Total Duration Weibull,Actual Total Duration Gamma,Actual Total Duration Lognormal,"
-			"Actual Total Duration Star Weibull,Actual Total Duration Star Gamma,Actual Total Duration Star Lognormal,"
-			"Total Number Of Failures Weibull,Total Number Of Failures Gamma, Total Number Of Failures Lognormal,"
-			"Total Number Of Failures Star Weibull,Total Number Of Failures Star Gamma, Total Number Of Failures Star Lognormal,"
-			"Redo,Diff Delta Weibull,Diff Delta Gamma,Diff Delta Lognormal,"
-			"Diff CT Weibull,Diff CT Gamma,Diff CT Lognormal,"
-			"Diff WT Weibull,Diff WT Gamma,Diff WT Lognormal\n";
-
-		for (int i = 0; i < averages.size(); i++)
-		{
-			for (int j = 0; j < averages[0].size(); j++)
-			{
-				ostream << averages[i][j];
-				if (j != averages[0].size() - 1)
-					ostream << ',';
-			}
-			ostream << '\n';
-		}
+		SummaryStore::ExportAverageCsv(stores, redoName, "Results/AverageRedo" + redoName + ".csv");
+		SummaryStore::ExportVarianceCsv(stores, groups, redoName, "Results/VarianceRedo" + redoName + ".csv");
 	}
 
 	long long Simulation::GetDeltaOpt()
@@ -618,151 +502,151 @@ namespace WSN
 
 
 	template<typename T>
-	void Distribution<T>::GenerateFailures(std::mt19937_64& random, long long totalDurationToBeTransferred)
+	void Distribution<T>::InitializeFailures(uint64_t seed, uint64_t stream, long long horizon, bool inverseSampling, bool flipUniforms)
 	{
-		long long currentFailure = 0;
-		
-		while (currentFailure < totalDurationToBeTransferred)
+		m_FailureSeed = seed;
+		m_FailureStream = stream;
+		m_FailureHorizon = horizon;
+		m_InverseSampling = inverseSampling;
+		m_FlipUniforms = flipUniforms;
+
+		// F(1) by bisection on the quantile, which is all the distributions provide
+		m_TruncatedMass = 0;
+		if (inverseSampling)
 		{
-			long long currentFailureInterval = m_Distribution(random);
-			while (currentFailureInterval <= 0)
-				currentFailureInterval = m_Distribution(random);
-
-			m_Intervals.push_back(currentFailureInterval);
-			currentFailure += currentFailureInterval;
-			m_FailurePoints.push_back(currentFailure);
+			double low = 0;
+			double high = 1;
+			for (int i = 0; i < 64; i++)
+			{
+				double middle = (low + high) / 2;
+				if (Quantile(m_Distribution, middle) < 1)
+					low = middle;
+				else
+					high = middle;
+			}
+			m_TruncatedMass = high;
 		}
+	}
 
-
-#if 0
-		for (int j = 2000; j < 3501; j += 100)
+	template<typename T>
+	FailureStream Distribution<T>::GetFailures() const
+	{
+		if (m_InverseSampling)
 		{
-			double average = 0.0;
-			for (int i = 0; i < j; i++)
-				average += (double)intervals[i] / j;
-
-			double stddev = 0.0;
-			for (int i = 0; i < j; i++)
-				stddev += std::pow(intervals[i] - average, 2) / (j - 1);
-			stddev = std::sqrt(stddev);
+			return FailureStream(m_FailureSeed, m_FailureStream, [distribution = m_Distribution, flipUniforms = m_FlipUniforms, truncatedMass = m_TruncatedMass](Philox& random, long long* intervals, long long count)
+				{
+					// exactly one uniform per interval, so that interval i of every distribution and of both redos of an antithetic pair comes from uniform i.
+					// Mapping it into [F(1), 1) draws from the distribution conditioned on intervals of at least 1, as rejecting the shorter ones would
+					for (long long i = 0; i < count; i++)
+					{
+						// (k + 0.5) / 2^53 lies strictly inside (0, 1) and 1 - u is exact
+						double u = ((random() >> 11) + 0.5) * 0x1.0p-53;
+						if (flipUniforms)
+							u = 1 - u;
 
-			std::cout << "LastFailure = " << j << ", Mean = " << average << ", StdDev = " << stddev << '\n';
+						// the max only guards against the rounding of F(1)
+						intervals[i] = std::max((long long)Quantile(distribution, truncatedMass + u * (1 - truncatedMass)), 1LL);
+					}
+				}, m_FailureHorizon);
 		}
 
-		for (int j = 250; j < 351; j += 2)
-		{
-			double average = 0.0;
-			for (int i = 0; i < j; i++)
-				average += (double)intervals[i] / j;
+		return FailureStream(m_FailureSeed, m_FailureStream, [distribution = m_Distribution, samples = std::vector<double>()](Philox& random, long long* intervals, long long count) mutable
+			{
+				samples.resize(count);
+				Sample(distribution, random, samples);
 
-			double stddev = 0.0;
-			for (int i = 0; i < j; i++)
-				stddev += std::pow(intervals[i] - average, 2) / (j - 1);
-			stddev = std::sqrt(stddev);
+				for (long long i = 0; i < count; i++)
+				{
+					long long currentFailureInterval = (long long)samples[i];
+					while (currentFailureInterval <= 0)
+					{
+						double resample;
+						Sample(distribution, random, { &resample, 1 });
+						currentFailureInterval = (long long)resample;
+					}
 
-			std::cout << "LastFailure = " << j << ", Mean = " << average << ", StdDev = " << stddev << '\n';
-		}
-#endif
+					intervals[i] = currentFailureInterval;
+				}
+			}, m_FailureHorizon);
 	}
 
 	template<typename T>
-	std::map<long long, long long> Distribution<T>::GetCDF(long long finalFailure)
+	std::pair<std::vector<long long>, std::vector<long long>> Distribution<T>::GetSortedIntervals(long long finalFailure, long long finalFailureStar) const
 	{
-		//std::cout << "FinalFail = " << finalFailure << ", Size = " << m_Intervals.size() << '\n';
-		std::vector<long long> tempIntervals(m_Intervals.begin(), m_Intervals.begin() + finalFailure);
+		finalFailure = std::max(finalFailure, 0LL);
+		finalFailureStar = std::max(finalFailureStar, 0LL);
 
-		std::sort(tempIntervals.begin(), tempIntervals.end());
+		const long long shortCount = std::min(finalFailure, finalFailureStar);
+		const long long longCount = std::max(finalFailure, finalFailureStar);
 
-		std::map<long long, long long> hist;
-		long long prevCount = 0;
-		for (int i = 0; i < tempIntervals.size(); i++)
-		{
+		FailureStream failures = GetFailures();
+		std::vector<long long> longIntervals(longCount);
+		for (long long i = 0; i < longCount; i++)
+			longIntervals[i] = failures.GetInterval(i);
 
-			long long currentInterval = tempIntervals[i];
-
-			int count = 1;
-			while (i + 1 < tempIntervals.size() && tempIntervals[i + 1] == currentInterval)
-			{
-				count++;
-				i++;
-			}
-			hist[currentInterval] = count + prevCount;
-			prevCount = count + prevCount;
+		std::sort(longIntervals.begin(), longIntervals.begin() + shortCount);
+		std::vector<long long> shortIntervals(longIntervals.begin(), longIntervals.begin() + shortCount);
 
-		}
+		std::sort(longIntervals.begin() + shortCount, longIntervals.end());
+		std::inplace_merge(longIntervals.begin(), longIntervals.begin() + shortCount, longIntervals.end());
 
-		return hist;
+		if (finalFailure <= finalFailureStar)
+			return { std::move(shortIntervals), std::move(longIntervals) };
+		return { std::move(longIntervals), std::move(shortIntervals) };
 	}
 
-	void Simulation::LogCDF()
+	static void WriteCDF(const std::string& path, const std::vector<long long> (&sorted)[3], const CDFSettings& settings)
 	{
-		std::string temp = "Results/Redo" + std::to_string(m_SummaryData.RedoCount) + "/";
-		std::string temp2 = "M" + std::to_string(m_SummaryData.Mean) + 'S' + std::to_string(m_SummaryData.StdDev)
-			+ "DUR" + std::to_string(m_SummaryData.TotalDurationToBeTransferred) + 'T' + std::to_string(m_SummaryData.TransferTime) + 'R' + std::to_string(m_SummaryData.RecoveryTime) + "CDF.csv";
+		std::vector<CDFPoint> cdfs[3];
 
+		if (settings.Resolution == CDFResolution::Quantiles)
 		{
-
-			std::map<long long, long long> weibull = m_Weibull.GetCDF(m_SummaryData.FinalFailureIndexWeibull);
-			std::map<long long, long long> gamma = m_Gamma.GetCDF(m_SummaryData.FinalFailureIndexGamma);
-			std::map<long long, long long> lognormal = m_Lognormal.GetCDF(m_SummaryData.FinalFailureIndexLognormal);
-
-			long long biggest = std::max(std::max((--weibull.end())->first, (--gamma.end())->first), (--lognormal.end())->first);
-			long long prevInterval = -1;
-			double prevCDWeibull = 0;
-			double prevCDGamma = 0;
-			double prevCDLognormal = 0;
-
-			std::ofstream CDFstream(temp + "Simulation" + temp2);
-
-			CDFstream << "Weibull,,,,Gamma,,,,Lognormal\n\n";
-			CDFstream << "Failure Count," << m_SummaryData.FinalFailureIndexWeibull << ",,,Failure Count," << m_SummaryData.FinalFailureIndexGamma << ",,,Failure Count," << m_SummaryData.FinalFailureIndexLognormal << "\n\n";
-
-			for (int i = 0; i <= biggest; i++)
-			{
-				if (weibull.find(i) != weibull.end())
-					prevCDWeibull = weibull[i] / (double)m_SummaryData.FinalFailureIndexWeibull;
-				if (gamma.find(i) != gamma.end())
-					prevCDGamma = gamma[i] / (double)m_SummaryData.FinalFailureIndexGamma;
-				if (lognormal.find(i) != lognormal.end())
-					prevCDLognormal = lognormal[i] / (double)m_SummaryData.FinalFailureIndexLognormal;
-
-				CDFstream << i << ',' << prevCDWeibull << ",,," << i << ',' << prevCDGamma << ",,," << i << ',' << prevCDLognormal << '\n';
-
-			}
+			for (int i = 0; i < 3; i++)
+				cdfs[i] = GetQuantileCDF(sorted[i], settings.PointCount);
 		}
-
+		else
 		{
+			long long biggest = 0;
+			for (int i = 0; i < 3; i++)
+				if (!sorted[i].empty())
+					biggest = std::max(biggest, sorted[i].back());
+
+			std::vector<long long> points = GetCDFPoints(biggest, settings);
+			for (int i = 0; i < 3; i++)
+				cdfs[i] = EvaluateCDF(sorted[i], points);
+		}
 
-			std::map<long long, long long> weibullStar = m_Weibull.GetCDF(m_SummaryData.FinalFailureIndexStarWeibull);
-			std::map<long long, long long> gammaStar = m_Gamma.GetCDF(m_SummaryData.FinalFailureIndexStarGamma);
-			std::map<long long, long long> lognormalStar = m_Lognormal.GetCDF(m_SummaryData.FinalFailureIndexStarLognormal);
-
-			long long biggest = std::max(std::max((--weibullStar.end())->first, (--gammaStar.end())->first), (--lognormalStar.end())->first);
-			long long prevInterval = -1;
-			double prevCDWeibull = 0;
-			double prevCDGamma = 0;
-			double prevCDLognormal = 0;
-
-			std::ofstream CDFstream(temp + "BruteForce" + temp2);
+		std::ofstream CDFstream(path);
 
-			CDFstream << "Weibull,,,,Gamma,,,,Lognormal\n\n";
-			CDFstream << "Failure Count," << m_SummaryData.FinalFailureIndexStarWeibull << ",,,Failure Count," << m_SummaryData.FinalFailureIndexStarGamma << ",,,Failure Count," << m_SummaryData.FinalFailureIndexStarLognormal << "\n\n";
+		CDFstream << "Weibull,,,,Gamma,,,,Lognormal\n\n";
+		CDFstream << "Failure Count," << sorted[0].size() << ",,,Failure Count," << sorted[1].size() << ",,,Failure Count," << sorted[2].size() << "\n\n";
 
-			for (int i = 0; i <= biggest; i++)
+		size_t rowCount = std::max(std::max(cdfs[0].size(), cdfs[1].size()), cdfs[2].size());
+		for (size_t row = 0; row < rowCount; row++)
+		{
+			for (int i = 0; i < 3; i++)
 			{
-				if (weibullStar.find(i) != weibullStar.end())
-					prevCDWeibull = weibullStar[i] / (double)m_SummaryData.FinalFailureIndexStarWeibull;
-				if (gammaStar.find(i) != gammaStar.end())
-					prevCDGamma = gammaStar[i] / (double)m_SummaryData.FinalFailureIndexStarGamma;
-				if (lognormalStar.find(i) != lognormalStar.end())
-					prevCDLognormal = lognormalStar[i] / (double)m_SummaryData.FinalFailureIndexStarLognormal;
-
-				CDFstream << i << ',' << prevCDWeibull << ",,," << i << ',' << prevCDGamma << ",,," << i << ',' << prevCDLognormal << '\n';
+				if (row < cdfs[i].size())
+					CDFstream << cdfs[i][row].Interval << ',' << cdfs[i][row].Probability;
+				else
+					CDFstream << ',';
 
+				CDFstream << (i < 2 ? ",,," : "\n");
 			}
 		}
+	}
+
+	void Simulation::LogCDF(const CDFSettings& settings)
+	{
+		auto [weibull, weibullStar] = m_Weibull.GetSortedIntervals(m_SummaryData.FinalFailureIndexWeibull, m_SummaryData.FinalFailureIndexStarWeibull);
+		auto [gamma, gammaStar] = m_Gamma.GetSortedIntervals(m_SummaryData.FinalFailureIndexGamma, m_SummaryData.FinalFailureIndexStarGamma);
+		auto [lognormal, lognormalStar] = m_Lognormal.GetSortedIntervals(m_SummaryData.FinalFailureIndexLognormal, m_SummaryData.FinalFailureIndexStarLognormal);
 
+		std::vector<long long> simulation[3] = { std::move(weibull), std::move(gamma), std::move(lognormal) };
+		WriteCDF(GetResultFilePath("Simulation", "CDF.csv"), simulation, settings);
 
+		std::vector<long long> bruteForce[3] = { std::move(weibullStar), std::move(gammaStar), std::move(lognormalStar) };
+		WriteCDF(GetResultFilePath("BruteForce", "CDF.csv"), bruteForce, settings);
 	}
 
-}
\ No newline at end of file
+}
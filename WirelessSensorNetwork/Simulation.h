@@ -1,5 +1,7 @@
 #pragma once
 #include "DistributionParameters.h"
+#include "FailureStream.h"
+#include "CDF.h"
 
 namespace WSN
 {
@@ -11,6 +13,55 @@ namespace WSN
 		Recovery
 	};
 
+	/// <summary>
+	/// StateMachine steps through every Collection/Transfer/Recovery state of a delta.
+	/// ClosedForm jumps from one failure to the next, giving the same BruteForceData in O(failures).
+	/// ClosedFormLanes runs ClosedForm on several deltas in lockstep with SIMD (see BruteForceLanes.h).
+	/// </summary>
+	enum class BruteForceEngine
+	{
+		StateMachine,
+		ClosedForm,
+		ClosedFormLanes
+	};
+
+	/// <summary>
+	/// Exhaustive evaluates every delta in [start, end) and logs all of them, for figure generation.
+	/// Adaptive starts on a coarse grid around DeltaOpt and refines around the best deltas found so far,
+	/// only the evaluated deltas are logged.
+	/// </summary>
+	enum class BruteForceSearch
+	{
+		Exhaustive,
+		Adaptive
+	};
+
+	/// <summary>
+	/// Off records nothing and never opens the trace file.
+	/// Sampled records one interval out of every sampleInterval, per distribution.
+	/// Full records every interval.
+	/// </summary>
+	enum class TraceMode
+	{
+		Off,
+		Sampled,
+		Full
+	};
+
+	/// <summary>
+	/// Independent draws every failure trace from its own Philox stream (node 1, 2 and 3 of the StreamKey).
+	/// CommonRandomNumbers draws one uniform stream per simulation and maps it through the inverse CDF of every
+	/// distribution, so that the Weibull, Gamma and Lognormal traces move together and their differences vary less.
+	/// </summary>
+	enum class FailureSampling
+	{
+		Independent,
+		CommonRandomNumbers
+	};
+
+	class TraceRecorder;
+	class SummaryLog;
+
 	struct SimulationInterval
 	{
 		State State;
@@ -27,9 +78,23 @@ namespace WSN
 		long long FinalFailureIndex = 0;
 	};
 
+	/// <summary>
+	/// Where a single delta stopped in its failure trace, so that brute force can walk many deltas
+	/// through the same FailureStream one chunk at a time
+	/// </summary>
+	struct BruteForceProgress
+	{
+		BruteForceData Data;
+		long long CurrentTime = 0;
+		long long TransferredTotalDuration = 0;
+		long long FailureIterator = 0;
+		State CurrentState = State::Collection;
+		bool Failed = false;
+		bool Done = false;
+	};
+
 	struct SimulationData
 	{
-		std::vector<SimulationInterval> SimulationIntervals;
 		BruteForceData BruteForceData;
 	};
 
@@ -96,49 +161,99 @@ namespace WSN
 			m_Distribution = T(a, b);
 		}
 
-		void GenerateFailures(std::mt19937_64& random, long long totalDurationToBeTransferred);
-
-		T m_Distribution;
-		std::vector<long long> m_FailurePoints;
-		std::vector<long long> m_Intervals;
+		/// <summary>
+		/// Sets the seed and Philox stream of the failure trace, the trace itself is only generated when read through GetFailures().
+		/// inverseSampling maps uniforms through the inverse CDF instead of the batch samplers of Samplers.h, flipUniforms then uses 1 - u instead of u.
+		/// </summary>
+		void InitializeFailures(uint64_t seed, uint64_t stream, long long horizon, bool inverseSampling = false, bool flipUniforms = false);
 
+		/// <summary>
+		/// A new reader of the failure trace, starting from the first failure
+		/// </summary>
+		FailureStream GetFailures() const;
 
-		std::map<long long, long long> GetCDF(long long finalFailure);
+		T m_Distribution;
+		uint64_t m_FailureSeed = 0;
+		uint64_t m_FailureStream = 0;
+		long long m_FailureHorizon = 0;
+		bool m_InverseSampling = false;
+		bool m_FlipUniforms = false;
+		// F(1) for the inverse CDF, the uniforms are mapped into [F(1), 1) so that no interval truncates to 0
+		double m_TruncatedMass = 0;
+
+
+		/// <summary>
+		/// The first finalFailure and the first finalFailureStar failure intervals, each sorted.
+		/// The longer prefix is built by merging the shorter one with the rest, so the trace is only sorted once.
+		/// </summary>
+		std::pair<std::vector<long long>, std::vector<long long>> GetSortedIntervals(long long finalFailure, long long finalFailureStar) const;
 	};
 
 	class Simulation
 	{
 	public:
-		Simulation(long long TotalDurationToBeTransferred, long long transferTime, long long recoveryTime, long long mean, long long stddev, long long redo);
-
-		void SimulateAll();
+		/// <summary>
+		/// Every failure trace is drawn from the Philox stream of streamKey (its node and purpose set here) under the master seed.
+		/// Both redos of an antithetic pair set antithetic, so that both go through the inverse CDF, and only the second one sets flipUniforms.
+		/// </summary>
+		Simulation(long long TotalDurationToBeTransferred, long long transferTime, long long recoveryTime, long long mean, long long stddev, long long redo,
+			uint64_t seed, const StreamKey& streamKey, FailureSampling sampling = FailureSampling::Independent, bool antithetic = false, bool flipUniforms = false);
+
+		/// <summary>
+		/// Simulates DeltaOpt on every distribution, the intervals go to a binary trace (see ExportTrace)
+		/// </summary>
+		void SimulateAll(TraceMode traceMode = TraceMode::Off);
 
 		template<typename T>
-		SimulationData SimulateSpecific(T& distribution);
+		SimulationData SimulateSpecific(T& distribution, TraceRecorder& trace, int pid);
+
+		/// <summary>
+		/// Converts the binary trace of the last SimulateAll to Chrome trace JSON and CSV
+		/// </summary>
+		void ExportTrace();
 
 
-		void BruteForceAll(long long start, long long end, long long step);
+		void BruteForceAll(long long start, long long end, long long step,
+			BruteForceEngine engine = BruteForceEngine::ClosedForm, BruteForceSearch search = BruteForceSearch::Exhaustive);
 
 		template<typename T>
-		std::vector<BruteForceData> BruteForceSpecific(T& distribution, long long start, long long end, long long step);
+		std::vector<BruteForceData> BruteForceSpecific(T& distribution, long long start, long long end, long long step, BruteForceEngine engine);
 
-		void Summarize();
-		static void LogSummary();
-		static void AverageAllRedos(int redoStart, int redoEnd);
+		template<typename T>
+		std::vector<BruteForceData> BruteForceAdaptive(T& distribution, long long start, long long end, long long step, BruteForceEngine engine);
+
+		template<typename T>
+		std::vector<BruteForceData> BruteForceDeltas(T& distribution, const std::vector<long long>& deltas, BruteForceEngine engine);
+
+		/// <summary>
+		/// The StateMachineKernel.h state machine without tracing, until progress finishes or needs the failure point at failureEnd
+		/// </summary>
+		void AdvanceBruteForce(BruteForceProgress& progress, const FailureStream& failures, long long failureEnd) const;
+
+		void AdvanceBruteForceClosedForm(BruteForceProgress& progress, const FailureStream& failures, long long failureEnd) const;
+
+		/// <summary>
+		/// Hands the summary to log, order being the position of this simulation in the sweep
+		/// </summary>
+		void Summarize(SummaryLog& log, long long order) const;
+		/// <summary>
+		/// Averages every redo summary and writes the variance of each averaged column.
+		/// With antithetic, redos redoStart + 2k and redoStart + 2k + 1 are paired and the variance is estimated from the pair means.
+		/// </summary>
+		static void AverageAllRedos(int redoStart, int redoEnd, bool antithetic = false);
 
 		long long GetDeltaOpt();
 
-		void LogCDF();
-	private:
+		inline const SimulationSummaryData& GetSummaryData() const { return m_SummaryData; }
 
-		static std::vector<SimulationSummaryData> s_Summary;
+		void LogCDF(const CDFSettings& settings = {});
+	private:
+		std::string GetResultFilePath(const std::string& name, const std::string& extension) const;
 
 		Distribution<std::weibull_distribution<double>> m_Weibull;
 		Distribution<std::gamma_distribution<double>> m_Gamma;
 		Distribution<std::lognormal_distribution<double>> m_Lognormal;
 
-		std::mt19937_64 m_Random;
-
 		SimulationSummaryData m_SummaryData;
 
 
@@ -0,0 +1,194 @@
+#pragma once
+#include "Simulation.h"
+#include "FailureStream.h"
+#include "TraceRecorder.h"
+
+namespace WSN
+{
+	// Compile time policies of AdvanceStateMachine, a disabled feature compiles away entirely.
+
+	/// <summary>
+	/// Counts CollectionTime and WastedTime, as needed for DeltaStar
+	/// </summary>
+	struct WastedTimeAccounting
+	{
+		static constexpr bool c_CountsTime = true;
+	};
+
+	/// <summary>
+	/// Only ActualTotalDuration and FinalFailureIndex
+	/// </summary>
+	struct CompletionAccounting
+	{
+		static constexpr bool c_CountsTime = false;
+	};
+
+	struct NoTrace
+	{
+		static constexpr bool c_Enabled = false;
+
+		inline void Record(State, long long, long long) {}
+	};
+
+	struct RecorderTrace
+	{
+		static constexpr bool c_Enabled = true;
+
+		TraceRecorder& Recorder;
+		int Pid;
+
+		inline void Record(State state, long long startTime, long long endTime) { Recorder.Record(Pid, { state, startTime, endTime }); }
+	};
+
+	struct StateMachineParameters
+	{
+		long long TotalDurationToBeTransferred;
+		long long TransferTime;
+		long long RecoveryTime;
+	};
+
+	/// <summary>
+	/// The Collection/Transfer/Recovery state machine of a single delta, one state at a time, shared by
+	/// Simulation::SimulateSpecific and Simulation::AdvanceBruteForce. Runs until everything is transferred or
+	/// the failure point at failureEnd is needed, failures must be prepared up to failureEnd.
+	/// Time is the type the loop keeps its times in, progress always stores them as long long.
+	/// </summary>
+	template<typename Time, typename Accounting, typename Trace>
+	void AdvanceStateMachine(BruteForceProgress& progress, const FailureStream& failures, long long failureEnd,
+		const StateMachineParameters& params, Trace& trace)
+	{
+		static_assert(std::is_integral_v<Time> && std::is_signed_v<Time>, "The state machine needs signed integer times!");
+
+		if (progress.Done)
+			return;
+
+		const Time delta = (Time)progress.Data.Delta;
+		const Time transferTime = (Time)params.TransferTime;
+		const Time recoveryTime = (Time)params.RecoveryTime;
+		const Time totalDurationToBeTransferred = (Time)params.TotalDurationToBeTransferred;
+
+		Time currentTime = (Time)progress.CurrentTime;
+		Time transferredTotalDuration = (Time)progress.TransferredTotalDuration;
+		Time collectionTime = (Time)progress.Data.CollectionTime;
+		Time wastedTime = (Time)progress.Data.WastedTime;
+		bool failed = progress.Failed;
+		long long failureIterator = progress.FailureIterator;
+		State currentState = progress.CurrentState;
+
+		// a paused delta always waits on its next failure, which is read below
+		Time nextFailureTime = failed ? 0 : (Time)failures[failureIterator];
+
+		auto save = [&]()
+		{
+			progress.CurrentTime = currentTime;
+			progress.TransferredTotalDuration = transferredTotalDuration;
+			progress.Failed = failed;
+			progress.FailureIterator = failureIterator;
+			progress.CurrentState = currentState;
+			if constexpr (Accounting::c_CountsTime)
+			{
+				progress.Data.CollectionTime = collectionTime;
+				progress.Data.WastedTime = wastedTime;
+			}
+		};
+
+		while (transferredTotalDuration < totalDurationToBeTransferred)
+		{
+			if (failed)
+			{
+				if (failureIterator + 1 >= failureEnd)
+				{
+					save();
+					return;
+				}
+
+				failureIterator++;
+				if (!failures.Has(failureIterator))
+					throw std::runtime_error("Exceeded the last failure point!");
+
+				nextFailureTime = (Time)failures[failureIterator];
+				failed = false;
+			}
+
+			if (currentState == State::Collection)
+			{
+				Time nextTime = currentTime + delta;
+				if (nextTime > nextFailureTime)
+				{
+					failed = true;
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Collection, currentTime, nextFailureTime);
+					currentState = State::Recovery;
+					if constexpr (Accounting::c_CountsTime)
+						wastedTime += nextFailureTime - currentTime;
+					currentTime = nextFailureTime;
+				}
+				else
+				{
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Collection, currentTime, nextTime);
+					currentState = State::Transfer;
+					currentTime = nextTime;
+					if constexpr (Accounting::c_CountsTime)
+						collectionTime += delta;
+				}
+			}
+			else if (currentState == State::Transfer)
+			{
+				Time nextTime = currentTime + transferTime;
+				if (nextTime > nextFailureTime)
+				{
+					// the delta collected before this transfer is lost as well
+					failed = true;
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Transfer, currentTime, nextFailureTime);
+					currentState = State::Recovery;
+					if constexpr (Accounting::c_CountsTime)
+					{
+						wastedTime += delta + nextFailureTime - currentTime;
+						collectionTime -= delta;
+					}
+					currentTime = nextFailureTime;
+				}
+				else
+				{
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Transfer, currentTime, nextTime);
+					currentState = State::Collection;
+					currentTime = nextTime;
+					if constexpr (Accounting::c_CountsTime)
+						wastedTime += transferTime;
+					transferredTotalDuration += delta;
+				}
+			}
+			else
+			{
+				Time nextTime = currentTime + recoveryTime;
+				if (nextTime > nextFailureTime)
+				{
+					failed = true;
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Recovery, currentTime, nextFailureTime);
+					currentState = State::Recovery;
+					if constexpr (Accounting::c_CountsTime)
+						wastedTime += nextFailureTime - currentTime;
+					currentTime = nextFailureTime;
+				}
+				else
+				{
+					if constexpr (Trace::c_Enabled)
+						trace.Record(State::Recovery, currentTime, nextTime);
+					currentState = State::Collection;
+					currentTime = nextTime;
+					if constexpr (Accounting::c_CountsTime)
+						wastedTime += recoveryTime;
+				}
+			}
+		}
+
+		save();
+		progress.Data.ActualTotalDuration = currentTime;
+		progress.Data.FinalFailureIndex = failureIterator - 1;
+		progress.Done = true;
+	}
+}
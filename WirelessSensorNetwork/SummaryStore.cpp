@@ -0,0 +1,316 @@
+#include "WSNPCH.h"
+#include "SummaryStore.h"
+
+namespace WSN
+{
+	static constexpr const char* c_SummaryDiffsHeader = "Diff Delta Weibull,Diff Delta Gamma,Diff Delta Lognormal,"
+		"Diff CT Weibull,Diff CT Gamma,Diff CT Lognormal,"
+		"Diff WT Weibull,Diff WT Gamma,Diff WT Lognormal";
+
+	/// <summary>
+	/// get(member) returns the value of a column as a double
+	/// </summary>
+	template<typename F>
+	static SummaryDiffs GetSummaryDiffs(F&& get)
+	{
+		using Members = long long SimulationSummaryData::*[3];
+		static constexpr Members deltaStar = { &SimulationSummaryData::DeltaStarWeibull, &SimulationSummaryData::DeltaStarGamma, &SimulationSummaryData::DeltaStarLognormal };
+		static constexpr Members collectionTime = { &SimulationSummaryData::CollectionTimeWeibull, &SimulationSummaryData::CollectionTimeGamma, &SimulationSummaryData::CollectionTimeLognormal };
+		static constexpr Members collectionTimeStar = { &SimulationSummaryData::CollectionTimeStarWeibull, &SimulationSummaryData::CollectionTimeStarGamma, &SimulationSummaryData::CollectionTimeStarLognormal };
+		static constexpr Members wastedTime = { &SimulationSummaryData::WastedTimeWeibull, &SimulationSummaryData::WastedTimeGamma, &SimulationSummaryData::WastedTimeLognormal };
+		static constexpr Members wastedTimeStar = { &SimulationSummaryData::WastedTimeStarWeibull, &SimulationSummaryData::WastedTimeStarGamma, &SimulationSummaryData::WastedTimeStarLognormal };
+
+		SummaryDiffs diffs;
+		for (int i = 0; i < 3; i++)
+		{
+			// (opt - star) / star, collection time is (star - opt) / star so that every diff is positive when DeltaOpt does worse
+			diffs.Delta[i] = (get(&SimulationSummaryData::DeltaOpt) - get(deltaStar[i])) / get(deltaStar[i]);
+			diffs.CollectionTime[i] = (get(collectionTimeStar[i]) - get(collectionTime[i])) / get(collectionTimeStar[i]);
+			diffs.WastedTime[i] = (get(wastedTime[i]) - get(wastedTimeStar[i])) / get(wastedTimeStar[i]);
+		}
+
+		return diffs;
+	}
+
+	static void WriteSummaryHeader(std::ofstream& stream)
+	{
+		for (const SummaryColumn& column : c_SummaryColumns)
+			stream << column.Name << ',';
+		stream << c_SummaryDiffsHeader << '\n';
+	}
+
+	SummaryStore::SummaryStore(const std::string& directory)
+		: m_Directory(directory)
+	{
+	}
+
+	std::string SummaryStore::GetColumnPath(const SummaryColumn& column) const
+	{
+		return m_Directory + '/' + column.Identifier + ".i64";
+	}
+
+	void SummaryStore::Append(const SimulationSummaryData& data)
+	{
+		std::filesystem::create_directories(m_Directory);
+
+		for (const SummaryColumn& column : c_SummaryColumns)
+		{
+			std::ofstream stream(GetColumnPath(column), std::ios::binary | std::ios::app);
+			stream.write((const char*)&(data.*column.Member), sizeof(long long));
+		}
+	}
+
+	void SummaryStore::Clear()
+	{
+		std::filesystem::remove_all(m_Directory);
+	}
+
+	long long SummaryStore::GetRowCount() const
+	{
+		long long rowCount = -1;
+		for (const SummaryColumn& column : c_SummaryColumns)
+		{
+			std::error_code error;
+			long long size = (long long)std::filesystem::file_size(GetColumnPath(column), error);
+			if (error)
+				return 0;
+
+			long long columnRowCount = size / (long long)sizeof(long long);
+			rowCount = rowCount < 0 ? columnRowCount : std::min(rowCount, columnRowCount);
+		}
+
+		return std::max(rowCount, 0LL);
+	}
+
+	std::vector<long long> SummaryStore::ReadColumn(const SummaryColumn& column) const
+	{
+		std::vector<long long> values(GetRowCount());
+
+		std::ifstream stream(GetColumnPath(column), std::ios::binary);
+		stream.read((char*)values.data(), values.size() * sizeof(long long));
+		if (!stream)
+			throw std::runtime_error("Could not read the summary column " + GetColumnPath(column) + '!');
+
+		return values;
+	}
+
+	std::vector<SimulationSummaryData> SummaryStore::ReadAll() const
+	{
+		std::vector<SimulationSummaryData> rows(GetRowCount());
+
+		for (const SummaryColumn& column : c_SummaryColumns)
+		{
+			std::vector<long long> values = ReadColumn(column);
+			for (size_t i = 0; i < rows.size(); i++)
+				rows[i].*column.Member = values[i];
+		}
+
+		return rows;
+	}
+
+	void SummaryStore::ExportCsv(const std::string& path) const
+	{
+		std::ofstream stream(path);
+		WriteSummaryHeader(stream);
+
+		for (const SimulationSummaryData& row : ReadAll())
+		{
+			for (const SummaryColumn& column : c_SummaryColumns)
+				stream << row.*column.Member << ',';
+
+			SummaryDiffs diffs = GetSummaryDiffs([&](long long SimulationSummaryData::* member) { return (double)(row.*member); });
+			for (double diff : diffs.Delta)
+				stream << diff << ',';
+			for (double diff : diffs.CollectionTime)
+				stream << diff << ',';
+			for (double diff : diffs.WastedTime)
+				stream << diff << ',';
+			stream << '\n';
+		}
+	}
+
+	using SummaryKey = std::array<long long, 5>;
+
+	/// <summary>
+	/// Rows of every store (with the index of their store), grouped by parameters in order of first appearance
+	/// </summary>
+	struct SummaryRows
+	{
+		std::vector<SummaryKey> Keys;
+		std::map<SummaryKey, std::vector<std::pair<size_t, SimulationSummaryData>>> Rows;
+	};
+
+	static SummaryRows CollectSummaryRows(const std::vector<SummaryStore>& stores)
+	{
+		SummaryRows summaryRows;
+		for (size_t s = 0; s < stores.size(); s++)
+		{
+			for (const SimulationSummaryData& row : stores[s].ReadAll())
+			{
+				SummaryKey key = { row.Mean, row.StdDev, row.TotalDurationToBeTransferred, row.TransferTime, row.RecoveryTime };
+				auto& rows = summaryRows.Rows[key];
+				if (rows.empty())
+					summaryRows.Keys.push_back(key);
+				rows.push_back({ s, row });
+			}
+		}
+
+		return summaryRows;
+	}
+
+	void SummaryStore::ExportAverageCsv(const std::vector<SummaryStore>& stores, const std::string& redoName, const std::string& path)
+	{
+		SummaryRows summaryRows = CollectSummaryRows(stores);
+
+		std::ofstream stream(path);
+		WriteSummaryHeader(stream);
+
+		for (const SummaryKey& key : summaryRows.Keys)
+		{
+			const auto& rows = summaryRows.Rows[key];
+
+			std::array<double, c_SummaryColumnCount> averages = {};
+			for (const auto& [store, row] : rows)
+				for (int c = 0; c < c_SummaryColumnCount; c++)
+					averages[c] += (row.*c_SummaryColumns[c].Member) / (double)rows.size();
+
+			for (int c = 0; c < c_SummaryColumnCount; c++)
+			{
+				if (c_SummaryColumns[c].Member != &SimulationSummaryData::RedoCount)
+					stream << std::to_string(averages[c]) << ',';
+				else if (rows.size() == stores.size())
+					stream << redoName << ',';
+				else
+					// points stopped early by a StoppingRule
+					stream << redoName << " (" << rows.size() << " redos),";
+			}
+
+			SummaryDiffs diffs = GetSummaryDiffs([&](long long SimulationSummaryData::* member)
+				{
+					for (int c = 0; c < c_SummaryColumnCount; c++)
+						if (c_SummaryColumns[c].Member == member)
+							return averages[c];
+					return 0.0;
+				});
+			for (double diff : diffs.Delta)
+				stream << std::to_string(diff) << ',';
+			for (double diff : diffs.CollectionTime)
+				stream << std::to_string(diff) << ',';
+			for (int d = 0; d < 3; d++)
+				stream << std::to_string(diffs.WastedTime[d]) << (d < 2 ? "," : "");
+			stream << '\n';
+		}
+	}
+
+	void SummaryStore::ExportVarianceCsv(const std::vector<SummaryStore>& stores, const std::vector<long long>& groups, const std::string& redoName, const std::string& path)
+	{
+		static constexpr int valueCount = c_SummaryColumnCount + 9;
+
+		SummaryRows summaryRows = CollectSummaryRows(stores);
+
+		std::ofstream stream(path);
+		WriteSummaryHeader(stream);
+
+		for (const SummaryKey& key : summaryRows.Keys)
+		{
+			const auto& rows = summaryRows.Rows[key];
+
+			// group means of every column followed by the diffs
+			std::map<long long, std::array<double, valueCount>> groupMeans;
+			std::map<long long, int> groupSizes;
+			for (const auto& [store, row] : rows)
+				groupSizes[groups[store]]++;
+
+			for (const auto& [store, row] : rows)
+			{
+				SummaryDiffs diffs = GetSummaryDiffs([&](long long SimulationSummaryData::* member) { return (double)(row.*member); });
+
+				std::array<double, valueCount> values;
+				for (int c = 0; c < c_SummaryColumnCount; c++)
+					values[c] = (double)(row.*c_SummaryColumns[c].Member);
+				for (int d = 0; d < 3; d++)
+				{
+					values[c_SummaryColumnCount + d] = diffs.Delta[d];
+					values[c_SummaryColumnCount + 3 + d] = diffs.CollectionTime[d];
+					values[c_SummaryColumnCount + 6 + d] = diffs.WastedTime[d];
+				}
+
+				auto& means = groupMeans.try_emplace(groups[store]).first->second;
+				for (int v = 0; v < valueCount; v++)
+					means[v] += values[v] / groupSizes[groups[store]];
+			}
+
+			const double groupCount = (double)groupMeans.size();
+
+			for (int v = 0; v < valueCount; v++)
+			{
+				if (v < c_SummaryColumnCount && c_SummaryColumns[v].Member == &SimulationSummaryData::RedoCount)
+					stream << redoName;
+				else if (groupCount >= 2)
+				{
+					double mean = 0;
+					for (const auto& [group, means] : groupMeans)
+						mean += means[v] / groupCount;
+
+					double variance = 0;
+					for (const auto& [group, means] : groupMeans)
+						variance += (means[v] - mean) * (means[v] - mean) / (groupCount - 1);
+
+					// variance of the average of groupCount independent groups, in scientific notation as it gets tiny for the diffs
+					stream << std::scientific << std::setprecision(6) << variance / groupCount;
+				}
+
+				if (v != valueCount - 1)
+					stream << ',';
+			}
+			stream << '\n';
+		}
+	}
+
+	std::string GetSummaryStorePath(long long redo)
+	{
+		return "Results/Redo" + std::to_string(redo) + "/Summary";
+	}
+
+	void SummaryLog::Add(long long order, const SimulationSummaryData& data)
+	{
+		Insert(order, data.RedoCount, data);
+	}
+
+	void SummaryLog::ExportCsvs()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (long long redo : m_RedoLogged)
+			SummaryStore(GetSummaryStorePath(redo)).ExportCsv("Results/Redo" + std::to_string(redo) + "/Summary.csv");
+	}
+
+	void SummaryLog::Skip(long long order, long long redo)
+	{
+		Insert(order, redo, std::nullopt);
+	}
+
+	void SummaryLog::Insert(long long order, long long redo, std::optional<SimulationSummaryData> data)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Pending[order] = { redo, std::move(data) };
+
+		while (!m_Pending.empty() && m_Pending.begin()->first == m_NextOrder)
+		{
+			const auto& [currentRedo, current] = m_Pending.begin()->second;
+			SummaryStore store(GetSummaryStorePath(currentRedo));
+
+			if (std::find(m_RedoLogged.begin(), m_RedoLogged.end(), currentRedo) == m_RedoLogged.end())
+			{
+				m_RedoLogged.push_back(currentRedo);
+				store.Clear();
+			}
+
+			if (current)
+				store.Append(*current);
+
+			m_Pending.erase(m_Pending.begin());
+			m_NextOrder++;
+		}
+	}
+}
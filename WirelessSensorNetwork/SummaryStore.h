@@ -0,0 +1,151 @@
+#pragma once
+#include "Simulation.h"
+
+namespace WSN
+{
+	struct SummaryColumn
+	{
+		const char* Identifier; // file name of the column
+		const char* Name; // CSV header
+		long long SimulationSummaryData::* Member;
+	};
+
+	/// <summary>
+	/// Every SimulationSummaryData field, in CSV order
+	/// </summary>
+	inline constexpr SummaryColumn c_SummaryColumns[] =
+	{
+		{ "Mean", "Mean", &SimulationSummaryData::Mean },
+		{ "StdDev", "Standard Deviation", &SimulationSummaryData::StdDev },
+		{ "TotalDurationToBeTransferred", "Total Duration To Be Transferred", &SimulationSummaryData::TotalDurationToBeTransferred },
+		{ "TransferTime", "Transfer Time", &SimulationSummaryData::TransferTime },
+		{ "RecoveryTime", "Recovery Time", &SimulationSummaryData::RecoveryTime },
+		{ "DeltaOpt", "Delta Optimal", &SimulationSummaryData::DeltaOpt },
+		{ "DeltaStarWeibull", "Delta Star Weibull", &SimulationSummaryData::DeltaStarWeibull },
+		{ "DeltaStarGamma", "Delta Star Gamma", &SimulationSummaryData::DeltaStarGamma },
+		{ "DeltaStarLognormal", "Delta Star Lognormal", &SimulationSummaryData::DeltaStarLognormal },
+		{ "CollectionTimeWeibull", "Collection Time Weibull", &SimulationSummaryData::CollectionTimeWeibull },
+		{ "CollectionTimeGamma", "Collection Time Gamma", &SimulationSummaryData::CollectionTimeGamma },
+		{ "CollectionTimeLognormal", "Collection Time Lognormal", &SimulationSummaryData::CollectionTimeLognormal },
+		{ "CollectionTimeStarWeibull", "Collection Time Star Weibull", &SimulationSummaryData::CollectionTimeStarWeibull },
+		{ "CollectionTimeStarGamma", "Collection Time Star Gamma", &SimulationSummaryData::CollectionTimeStarGamma },
+		{ "CollectionTimeStarLognormal", "Collection Time Star Lognormal", &SimulationSummaryData::CollectionTimeStarLognormal },
+		{ "WastedTimeWeibull", "Wasted Time Weibull", &SimulationSummaryData::WastedTimeWeibull },
+		{ "WastedTimeGamma", "Wasted Time Gamma", &SimulationSummaryData::WastedTimeGamma },
+		{ "WastedTimeLognormal", "Wasted Time Lognormal", &SimulationSummaryData::WastedTimeLognormal },
+		{ "WastedTimeStarWeibull", "Wasted Time Star Weibull", &SimulationSummaryData::WastedTimeStarWeibull },
+		{ "WastedTimeStarGamma", "Wasted Time Star Gamma", &SimulationSummaryData::WastedTimeStarGamma },
+		{ "WastedTimeStarLognormal", "Wasted Time Star Lognormal", &SimulationSummaryData::WastedTimeStarLognormal },
+		{ "ActualTotalDurationWeibull", "Actual Total Duration Weibull", &SimulationSummaryData::ActualTotalDurationWeibull },
+		{ "ActualTotalDurationGamma", "Actual Total Duration Gamma", &SimulationSummaryData::ActualTotalDurationGamma },
+		{ "ActualTotalDurationLognormal", "Actual Total Duration Lognormal", &SimulationSummaryData::ActualTotalDurationLognormal },
+		{ "ActualTotalDurationStarWeibull", "Actual Total Duration Star Weibull", &SimulationSummaryData::ActualTotalDurationStarWeibull },
+		{ "ActualTotalDurationStarGamma", "Actual Total Duration Star Gamma", &SimulationSummaryData::ActualTotalDurationStarGamma },
+		{ "ActualTotalDurationStarLognormal", "Actual Total Duration Star Lognormal", &SimulationSummaryData::ActualTotalDurationStarLognormal },
+		{ "FinalFailureIndexWeibull", "Total Number Of Failures Weibull", &SimulationSummaryData::FinalFailureIndexWeibull },
+		{ "FinalFailureIndexGamma", "Total Number Of Failures Gamma", &SimulationSummaryData::FinalFailureIndexGamma },
+		{ "FinalFailureIndexLognormal", " Total Number Of Failures Lognormal", &SimulationSummaryData::FinalFailureIndexLognormal },
+		{ "FinalFailureIndexStarWeibull", "Total Number Of Failures Star Weibull", &SimulationSummaryData::FinalFailureIndexStarWeibull },
+		{ "FinalFailureIndexStarGamma", "Total Number Of Failures Star Gamma", &SimulationSummaryData::FinalFailureIndexStarGamma },
+		{ "FinalFailureIndexStarLognormal", " Total Number Of Failures Star Lognormal", &SimulationSummaryData::FinalFailureIndexStarLognormal },
+		{ "RedoCount", "Redo", &SimulationSummaryData::RedoCount },
+	};
+
+	inline constexpr int c_SummaryColumnCount = sizeof(c_SummaryColumns) / sizeof(c_SummaryColumns[0]);
+
+	static_assert(c_SummaryColumnCount * sizeof(long long) == sizeof(SimulationSummaryData), "Every SimulationSummaryData field needs a summary column!");
+
+	/// <summary>
+	/// Relative differences between DeltaOpt and DeltaStar, for every distribution
+	/// </summary>
+	struct SummaryDiffs
+	{
+		double Delta[3];
+		double CollectionTime[3];
+		double WastedTime[3];
+	};
+
+	/// <summary>
+	/// Typed columnar store of SimulationSummaryData, one file per column in a directory.
+	/// Each column file is a raw array of long long, so appending a row appends one value
+	/// to every file and a column can be read (or memory mapped) in one go.
+	/// </summary>
+	class SummaryStore
+	{
+	public:
+		SummaryStore(const std::string& directory);
+
+		void Append(const SimulationSummaryData& data);
+
+		/// <summary>
+		/// Deletes every row
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Rows every column holds, a partially appended row is ignored
+		/// </summary>
+		long long GetRowCount() const;
+
+		std::vector<long long> ReadColumn(const SummaryColumn& column) const;
+
+		std::vector<SimulationSummaryData> ReadAll() const;
+
+		/// <summary>
+		/// Summary.csv layout : every column followed by the diff columns
+		/// </summary>
+		void ExportCsv(const std::string& path) const;
+
+		/// <summary>
+		/// Average of the rows sharing the same parameters (mean, stddev, durations) across the stores, which may hold
+		/// different numbers of rows. The diff columns are computed from the averages.
+		/// </summary>
+		static void ExportAverageCsv(const std::vector<SummaryStore>& stores, const std::string& redoName, const std::string& path);
+
+		/// <summary>
+		/// Same layout as ExportAverageCsv, with the estimated variance of every averaged column (diffs included).
+		/// Stores sharing a group id (antithetic pairs) are averaged together first, the variance then comes from the
+		/// spread of the group means. Cells are left empty with fewer than two groups.
+		/// </summary>
+		static void ExportVarianceCsv(const std::vector<SummaryStore>& stores, const std::vector<long long>& groups, const std::string& redoName, const std::string& path);
+
+	private:
+		std::string GetColumnPath(const SummaryColumn& column) const;
+
+		std::string m_Directory;
+	};
+
+	/// <summary>
+	/// Directory of the SummaryStore of a redo
+	/// </summary>
+	std::string GetSummaryStorePath(long long redo);
+
+	/// <summary>
+	/// Collects the summaries of simulations running side by side and logs them in sweep order :
+	/// a summary is appended to the store of its redo once every earlier one is in.
+	/// The first summary (or skip) of a redo clears whatever a previous run left in its store.
+	/// </summary>
+	class SummaryLog
+	{
+	public:
+		void Add(long long order, const SimulationSummaryData& data);
+
+		/// <summary>
+		/// Exports the Summary.csv of every redo logged so far, once the sweep is done
+		/// </summary>
+		void ExportCsvs();
+
+		/// <summary>
+		/// Marks order as never coming, so that the later summaries don't wait for it
+		/// </summary>
+		void Skip(long long order, long long redo);
+
+	private:
+		void Insert(long long order, long long redo, std::optional<SimulationSummaryData> data);
+
+		std::mutex m_Mutex;
+		std::map<long long, std::pair<long long, std::optional<SimulationSummaryData>>> m_Pending;
+		long long m_NextOrder = 0;
+		std::vector<long long> m_RedoLogged;
+	};
+}
@@ -0,0 +1,166 @@
+#include "WSNPCH.h"
+#include "Sweep.h"
+#include "SummaryStore.h"
+#include "ThreadPool.h"
+
+namespace WSN
+{
+	SweepExecutor::SweepExecutor(const SweepSettings& settings)
+		: m_Settings(settings)
+	{
+	}
+
+	StreamKey SweepExecutor::GetStreamKey(const SweepPoint& point) const
+	{
+		StreamKey key;
+		key.Point = MixBits(MixBits((uint64_t)point.Mean) ^ (uint64_t)point.StdDev);
+		key.Redo = m_Settings.Antithetic ? (point.Redo - m_Settings.FirstRedo) / 2 : point.Redo;
+		return key;
+	}
+
+	void SweepExecutor::LogSeed() const
+	{
+		std::filesystem::create_directories("Results");
+		std::ofstream stream("Results/Seed.txt");
+		stream << m_Settings.Seed << '\n';
+	}
+
+	double RunningStatistics::GetHalfWidth() const
+	{
+		// two sided 95% Student t quantiles for 1 to 30 degrees of freedom, the normal one past that
+		static constexpr double tQuantiles[] =
+		{
+			12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+		};
+
+		if (Count < 2)
+			return std::numeric_limits<double>::infinity();
+
+		long long degreesOfFreedom = Count - 1;
+		double t = degreesOfFreedom <= 30 ? tQuantiles[degreesOfFreedom - 1] : 1.96;
+		return t * std::sqrt(GetVariance() / Count);
+	}
+
+	SimulationSummaryData SweepExecutor::RunPoint(const SweepPoint& point, long long index, SummaryLog& log) const
+	{
+		std::ostringstream starting;
+		starting << "Starting :\t Redo : " << point.Redo << ",\t Standard Deviation : " << point.StdDev << ",\t Mean : " << point.Mean << '\n';
+		std::cout << starting.str();
+
+		// totalDurationToBeTransferred, transferTime, recoveryTime, mean, stddev, redo, seed, stream key, sampling, antithetic, flip uniforms
+		Simulation simulation(m_Settings.TotalDurationToBeTransferred, m_Settings.TransferTime, m_Settings.RecoveryTime,
+			point.Mean, point.StdDev, point.Redo, m_Settings.Seed, GetStreamKey(point), m_Settings.Sampling, m_Settings.Antithetic, IsPairSecond(point));
+
+		simulation.SimulateAll(m_Settings.TraceMode);
+		if (m_Settings.TraceMode != TraceMode::Off && m_Settings.ExportTraces)
+			simulation.ExportTrace();
+
+		// start delta, end delta, delta step
+		simulation.BruteForceAll(1, 3 * simulation.GetDeltaOpt(), 1, m_Settings.Engine, m_Settings.Search);
+
+		simulation.Summarize(log, index);
+		simulation.LogCDF(m_Settings.CDFSettings);
+
+		return simulation.GetSummaryData();
+	}
+
+	void SweepExecutor::Run(const std::vector<SweepPoint>& points)
+	{
+		std::cout << "Sweep seed = " << m_Settings.Seed << ", " << points.size() << " points on " << ThreadPool::Get().GetThreadCount() + 1 << " threads\n";
+		LogSeed();
+
+		SummaryLog log;
+		ThreadPool::Get().ParallelFor((long long)points.size(), [&](long long i)
+			{
+				RunPoint(points[i], i, log);
+			});
+		log.ExportCsvs();
+	}
+
+	long long SweepExecutor::RunUntilConverged(const std::vector<SweepPoint>& points, const StoppingRule& stoppingRule)
+	{
+		using Member = long long SimulationSummaryData::*;
+		static constexpr Member trackedColumns[] =
+		{
+			&SimulationSummaryData::DeltaStarWeibull, &SimulationSummaryData::DeltaStarGamma, &SimulationSummaryData::DeltaStarLognormal,
+			&SimulationSummaryData::WastedTimeStarWeibull, &SimulationSummaryData::WastedTimeStarGamma, &SimulationSummaryData::WastedTimeStarLognormal
+		};
+		static constexpr int trackedCount = sizeof(trackedColumns) / sizeof(trackedColumns[0]);
+
+		std::cout << "Sweep seed = " << m_Settings.Seed << ", " << points.size() << " points on " << ThreadPool::Get().GetThreadCount() + 1
+			<< " threads, until a relative half-width of " << stoppingRule.RelativeTolerance << " or " << stoppingRule.MaxRedos << " redos\n";
+		LogSeed();
+
+		const long long pointCount = (long long)points.size();
+		long long maxRedos = std::max(stoppingRule.MaxRedos, 1LL);
+		if (m_Settings.Antithetic)
+		{
+			// a pair is one observation, stopping halfway through it would leave a lone redo in the store
+			maxRedos += maxRedos % 2;
+
+			for (const SweepPoint& point : points)
+				if (IsPairSecond(point))
+					throw std::runtime_error("Antithetic redos have to start on the first redo of a pair!");
+		}
+		std::vector<long long> lastRedos(pointCount);
+
+		SummaryLog log;
+		ThreadPool::Get().ParallelFor(pointCount, [&](long long p)
+			{
+				RunningStatistics statistics[trackedCount];
+				// the first redo of an antithetic pair, waiting for the second one
+				std::optional<SimulationSummaryData> pairFirst;
+
+				SweepPoint point = points[p];
+				long long r = 0;
+				for (; r < maxRedos; r++)
+				{
+					point.Redo = points[p].Redo + r;
+					SimulationSummaryData summary = RunPoint(point, r * pointCount + p, log);
+					lastRedos[p] = point.Redo;
+
+					// antithetic redos only count as one observation per pair
+					if (m_Settings.Antithetic && !IsPairSecond(point))
+					{
+						pairFirst = summary;
+						continue;
+					}
+
+					for (int c = 0; c < trackedCount; c++)
+					{
+						double value = (double)(summary.*trackedColumns[c]);
+						if (pairFirst)
+							value = (value + (double)(*pairFirst.*trackedColumns[c])) / 2;
+						statistics[c].Add(value);
+					}
+					pairFirst.reset();
+
+					if (r + 1 < stoppingRule.MinRedos)
+						continue;
+
+					bool converged = true;
+					for (int c = 0; c < trackedCount; c++)
+						converged &= statistics[c].GetHalfWidth() <= stoppingRule.RelativeTolerance * std::abs(statistics[c].Mean);
+
+					if (converged)
+					{
+						r++;
+						break;
+					}
+				}
+
+				std::ostringstream stopped;
+				stopped << "Stopped :\t Standard Deviation : " << point.StdDev << ",\t Mean : " << point.Mean << ",\t after " << r << " redos\n";
+				std::cout << stopped.str();
+
+				// later redos of this point will never come, the log must not wait for them
+				for (; r < maxRedos; r++)
+					log.Skip(r * pointCount + p, points[p].Redo + r);
+			});
+		log.ExportCsvs();
+
+		return pointCount > 0 ? *std::max_element(lastRedos.begin(), lastRedos.end()) : 0;
+	}
+}
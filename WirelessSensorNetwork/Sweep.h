@@ -0,0 +1,109 @@
+#pragma once
+#include "Simulation.h"
+
+namespace WSN
+{
+	struct SweepPoint
+	{
+		long long Redo;
+		long long Mean;
+		long long StdDev;
+	};
+
+	/// <summary>
+	/// Runs redos of every point until the 95% confidence half-width of each DeltaStar and WastedTimeStar
+	/// falls below RelativeTolerance times its mean, or MaxRedos is reached
+	/// </summary>
+	struct StoppingRule
+	{
+		long long MinRedos = 3;
+		long long MaxRedos = 50;
+		double RelativeTolerance = 0.01;
+	};
+
+	/// <summary>
+	/// Mean and variance updated one observation at a time (Welford)
+	/// </summary>
+	struct RunningStatistics
+	{
+		long long Count = 0;
+		double Mean = 0;
+		double M2 = 0;
+
+		inline void Add(double x)
+		{
+			Count++;
+			double delta = x - Mean;
+			Mean += delta / Count;
+			M2 += delta * (x - Mean);
+		}
+
+		inline double GetVariance() const { return Count > 1 ? M2 / (Count - 1) : 0.0; }
+
+		/// <summary>
+		/// Half-width of the 95% confidence interval of the mean (Student t), infinite below two observations
+		/// </summary>
+		double GetHalfWidth() const;
+	};
+
+	struct SweepSettings
+	{
+		long long TotalDurationToBeTransferred;
+		long long TransferTime;
+		long long RecoveryTime;
+
+		BruteForceEngine Engine = BruteForceEngine::ClosedFormLanes;
+		BruteForceSearch Search = BruteForceSearch::Exhaustive;
+		TraceMode TraceMode = TraceMode::Off;
+		bool ExportTraces = false;
+		CDFSettings CDFSettings;
+
+		FailureSampling Sampling = FailureSampling::Independent;
+		// redos FirstRedo + 2k and FirstRedo + 2k + 1 share their streams, the second one sampling its failures with 1 - u
+		bool Antithetic = false;
+		// first redo of the sweep, the antithetic pairs start from it
+		long long FirstRedo = 1;
+
+		// master seed of every Philox stream of the sweep, written to Results/Seed.txt
+		uint64_t Seed = 0;
+	};
+
+	/// <summary>
+	/// Runs every point of a parameter sweep (SimulateAll, BruteForceAll, LogCDF) on the shared ThreadPool,
+	/// several points at a time. Every point writes its own files and the summaries are logged in sweep order,
+	/// so the results are the same as running the points one after the other with the same seeds.
+	/// </summary>
+	class SweepExecutor
+	{
+	public:
+		SweepExecutor(const SweepSettings& settings);
+
+		void Run(const std::vector<SweepPoint>& points);
+
+		/// <summary>
+		/// Runs redos point.Redo, point.Redo + 1, ... of every point until stoppingRule is met for that point.
+		/// With antithetic pairs, every point.Redo must start a pair and MaxRedos is rounded up to whole pairs.
+		/// Points run side by side, so the redos of the points still running take over the freed threads.
+		/// Returns the last redo run by any point.
+		/// </summary>
+		long long RunUntilConverged(const std::vector<SweepPoint>& points, const StoppingRule& stoppingRule);
+
+		/// <summary>
+		/// Stream key of the simulation of a point, from its parameters and redo only, so that its failures don't depend
+		/// on the thread running it nor on the other points. Both redos of an antithetic pair get the same key.
+		/// </summary>
+		StreamKey GetStreamKey(const SweepPoint& point) const;
+
+	private:
+		void LogSeed() const;
+
+		/// <summary>
+		/// Whether point is the second redo of its antithetic pair, the one sampling with 1 - u
+		/// </summary>
+		inline bool IsPairSecond(const SweepPoint& point) const { return m_Settings.Antithetic && (point.Redo - m_Settings.FirstRedo) % 2 == 1; }
+
+		SimulationSummaryData RunPoint(const SweepPoint& point, long long index, SummaryLog& log) const;
+
+		SweepSettings m_Settings;
+	};
+}
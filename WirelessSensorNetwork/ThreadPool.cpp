@@ -0,0 +1,59 @@
+#include "WSNPCH.h"
+#include "ThreadPool.h"
+
+namespace WSN
+{
+	ThreadPool::ThreadPool(unsigned int threadCount)
+	{
+		for (unsigned int i = 0; i < threadCount; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_Condition.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	ThreadPool& ThreadPool::Get()
+	{
+		// the calling thread also works inside ParallelFor, hence one less worker than hardware threads
+		static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+		return pool;
+	}
+
+	void ThreadPool::Enqueue(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Tasks.push_back(std::move(task));
+		}
+		m_Condition.notify_one();
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+
+				if (m_Stopping && m_Tasks.empty())
+					return;
+
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,179 @@
+#include "WSNPCH.h"
+#include "TraceRecorder.h"
+
+namespace WSN
+{
+	static std::string_view GetStateName(int state)
+	{
+		switch ((State)state)
+		{
+		case State::Collection: return "Collection";
+		case State::Transfer: return "Transfer";
+		case State::Recovery: return "Recovery";
+		}
+
+		return "";
+	}
+
+	/// <summary>
+	/// Formats into a fixed size buffer with std::to_chars and writes it out whenever it is nearly full
+	/// </summary>
+	class TextWriter
+	{
+	public:
+		static constexpr size_t c_BufferSize = 1 << 20;
+		// longer than any single Append
+		static constexpr size_t c_MaxAppendSize = 64;
+
+		TextWriter(const std::string& path)
+			: m_Stream(path, std::ios::binary), m_Buffer(c_BufferSize)
+		{
+			if (!m_Stream)
+				throw std::runtime_error("Could not open " + path + " for writing!");
+		}
+
+		~TextWriter()
+		{
+			Flush();
+		}
+
+		inline void Append(std::string_view text)
+		{
+			Reserve(text.size());
+			std::memcpy(m_Buffer.data() + m_Size, text.data(), text.size());
+			m_Size += text.size();
+		}
+
+		inline void Append(char c)
+		{
+			Reserve(1);
+			m_Buffer[m_Size++] = c;
+		}
+
+		inline void Append(long long value)
+		{
+			Reserve(c_MaxAppendSize);
+			m_Size = std::to_chars(m_Buffer.data() + m_Size, m_Buffer.data() + m_Buffer.size(), value).ptr - m_Buffer.data();
+		}
+
+		void Flush()
+		{
+			m_Stream.write(m_Buffer.data(), m_Size);
+			m_Size = 0;
+		}
+
+	private:
+		inline void Reserve(size_t size)
+		{
+			if (m_Size + size > m_Buffer.size())
+				Flush();
+		}
+
+		std::ofstream m_Stream;
+		std::vector<char> m_Buffer;
+		size_t m_Size = 0;
+	};
+
+	/// <summary>
+	/// Calls func(record) for every record of a binary trace file, reading it one buffer at a time
+	/// </summary>
+	template<typename F>
+	static void ReadTrace(const std::string& tracePath, F&& func)
+	{
+		std::ifstream stream(tracePath, std::ios::binary);
+		if (!stream)
+			throw std::runtime_error("Could not open " + tracePath + " for reading!");
+
+		TraceFileHeader header;
+		stream.read((char*)&header, sizeof(header));
+		if (!stream || std::memcmp(header.Magic, TraceFileHeader().Magic, sizeof(header.Magic)) != 0 || header.RecordSize != sizeof(TraceRecord))
+			throw std::runtime_error(tracePath + " is not a trace file!");
+
+		std::vector<TraceRecord> records(TraceRecorder::c_BufferRecordCount);
+		while (stream)
+		{
+			stream.read((char*)records.data(), records.size() * sizeof(TraceRecord));
+			size_t count = stream.gcount() / sizeof(TraceRecord);
+
+			for (size_t i = 0; i < count; i++)
+				func(records[i]);
+		}
+	}
+
+	TraceRecorder::TraceRecorder(const std::string& path, TraceMode mode, unsigned int sampleInterval)
+		: m_Mode(mode), m_SampleInterval(std::max(sampleInterval, 1u))
+	{
+		if (m_Mode == TraceMode::Off)
+			return;
+
+		m_Stream.open(path, std::ios::binary);
+		if (!m_Stream)
+			throw std::runtime_error("Could not open " + path + " for writing!");
+
+		TraceFileHeader header;
+		header.Mode = (unsigned int)m_Mode;
+		header.SampleInterval = m_Mode == TraceMode::Sampled ? m_SampleInterval : 1;
+		m_Stream.write((const char*)&header, sizeof(header));
+
+		m_Buffer.reserve(c_BufferRecordCount);
+	}
+
+	TraceRecorder::~TraceRecorder()
+	{
+		Flush();
+	}
+
+	void TraceRecorder::Flush()
+	{
+		if (m_Buffer.empty())
+			return;
+
+		m_Stream.write((const char*)m_Buffer.data(), m_Buffer.size() * sizeof(TraceRecord));
+		m_Buffer.clear();
+	}
+
+	void TraceRecorder::ExportJson(const std::string& tracePath, const std::string& jsonPath)
+	{
+		TextWriter writer(jsonPath);
+		bool first = true;
+
+		writer.Append('[');
+		ReadTrace(tracePath, [&](const TraceRecord& record)
+			{
+				if (!first)
+					writer.Append(",\n");
+				first = false;
+
+				writer.Append("{ \"cat\" : \"Node\", \"pid\" :");
+				writer.Append((long long)record.Pid);
+				writer.Append(",\"tid\" :");
+				writer.Append((long long)record.Pid);
+				writer.Append(",\"dur\" :");
+				writer.Append((record.EndTime - record.StartTime) * 1000000);
+				writer.Append(",\"ts\" :");
+				writer.Append(record.StartTime * 1000000);
+				writer.Append(",\"ph\" : \"X\",\"name\" :\"");
+				writer.Append(GetStateName(record.State));
+				writer.Append("\"}");
+			});
+		writer.Append("\n]");
+	}
+
+	void TraceRecorder::ExportCsv(const std::string& tracePath, const std::string& csvPath)
+	{
+		TextWriter writer(csvPath);
+
+		writer.Append("Node,State,Start Time,End Time\n");
+		ReadTrace(tracePath, [&](const TraceRecord& record)
+			{
+				writer.Append((long long)record.Pid);
+				writer.Append(',');
+				writer.Append(GetStateName(record.State));
+				writer.Append(',');
+				writer.Append(record.StartTime);
+				writer.Append(',');
+				writer.Append(record.EndTime);
+				writer.Append('\n');
+			});
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Simulation.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Fixed width record of the binary trace file, one per SimulationInterval
+	/// </summary>
+	struct TraceRecord
+	{
+		long long StartTime;
+		long long EndTime;
+		int Pid;
+		int State;
+	};
+
+	static_assert(sizeof(TraceRecord) == 24, "Trace records are written as is, their layout has to stay fixed!");
+
+	struct TraceFileHeader
+	{
+		char Magic[4] = { 'W', 'S', 'N', 'T' };
+		unsigned int RecordSize = sizeof(TraceRecord);
+		unsigned int Mode = 0;
+		unsigned int SampleInterval = 1;
+	};
+
+	/// <summary>
+	/// Records simulation intervals into a binary file through a fixed size buffer, flushed whenever it fills up.
+	/// The trace is only turned into text by ExportJson/ExportCsv, outside of the simulation.
+	/// </summary>
+	class TraceRecorder
+	{
+	public:
+		static constexpr size_t c_BufferRecordCount = 8192;
+		static constexpr unsigned int c_DefaultSampleInterval = 64;
+
+		TraceRecorder(const std::string& path, TraceMode mode, unsigned int sampleInterval = c_DefaultSampleInterval);
+		~TraceRecorder();
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		inline bool IsEnabled() const { return m_Mode != TraceMode::Off; }
+
+		inline void Record(int pid, const SimulationInterval& interval)
+		{
+			if (m_Mode == TraceMode::Off)
+				return;
+
+			if (m_Mode == TraceMode::Sampled && m_IntervalCounts[pid & (c_MaxPid - 1)]++ % m_SampleInterval != 0)
+				return;
+
+			m_Buffer.push_back({ interval.StartTime, interval.EndTime, pid, (int)interval.State });
+			if (m_Buffer.size() == c_BufferRecordCount)
+				Flush();
+		}
+
+		void Flush();
+
+		/// <summary>
+		/// Chrome trace (chrome://tracing) of a binary trace file, timestamps in microseconds
+		/// </summary>
+		static void ExportJson(const std::string& tracePath, const std::string& jsonPath);
+
+		/// <summary>
+		/// One "Node,State,Start Time,End Time" line per record of a binary trace file
+		/// </summary>
+		static void ExportCsv(const std::string& tracePath, const std::string& csvPath);
+
+	private:
+		static constexpr int c_MaxPid = 16;
+
+		TraceMode m_Mode;
+		unsigned int m_SampleInterval;
+		long long m_IntervalCounts[c_MaxPid] = {};
+
+		std::ofstream m_Stream;
+		std::vector<TraceRecord> m_Buffer;
+	};
+}
@@ -9,4 +9,21 @@
 #include <fstream>
 #include <filesystem>
 #include <stdexcept>
-#include <map>
\ No newline at end of file
+#include <map>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <exception>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <sstream>
+#include <limits>
+#include <array>
+#include <optional>
+#include <iomanip>
+#include <span>
\ No newline at end of file
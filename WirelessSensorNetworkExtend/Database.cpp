@@ -72,13 +72,13 @@ namespace WSN
         {
             static sql::PreparedStatement* statement1FTTDMA = s_Connection->prepareStatement(
                 "Insert into "
-                "SimulationFTTDMA(SimulationID, TotalDurationToBeTransferred, TransferTime, RecoveryTime, FailureDistributionType, FailureMean, FailureStddev, FailureParameter1, FailureParameter2, ActualTotalDuration, FinalFailureIndex, CWSNEfficiency, EnergyRateWorking, EnergyRateTransfer)"
-                " values(?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
+                "SimulationFTTDMA(SimulationID, TotalDurationToBeTransferred, TransferTime, RecoveryTime, FailureDistributionType, FailureMean, FailureStddev, FailureParameter1, FailureParameter2, ActualTotalDuration, FinalFailureIndex, CWSNEfficiency, EnergyRateWorking, EnergyRateTransfer, Seed, SweepPoint, Redo)"
+                " values(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
 
             static sql::PreparedStatement* statement1RRTDMA = s_Connection->prepareStatement(
                 "Insert into "
-                "SimulationRRTDMA(SimulationID, TotalDurationToBeTransferred, TransferTime, RecoveryTime, FailureDistributionType, FailureMean, FailureStddev, FailureParameter1, FailureParameter2, ActualTotalDuration, FinalFailureIndex, CWSNEfficiency, EnergyRateWorking, EnergyRateTransfer)"
-                " values(?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
+                "SimulationRRTDMA(SimulationID, TotalDurationToBeTransferred, TransferTime, RecoveryTime, FailureDistributionType, FailureMean, FailureStddev, FailureParameter1, FailureParameter2, ActualTotalDuration, FinalFailureIndex, CWSNEfficiency, EnergyRateWorking, EnergyRateTransfer, Seed, SweepPoint, Redo)"
+                " values(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
 
             sql::PreparedStatement* statement1 = nullptr;
             if (st == SimulationType::FT_TDMA)
@@ -102,6 +102,9 @@ namespace WSN
             statement1->setDouble(12, sr.CWSNEfficiency);
             statement1->setDouble(13, simulationParameters.EnergyRateWorking);
             statement1->setDouble(14, simulationParameters.EnergyRateTransfer);
+            statement1->setUInt64(15, simulationParameters.Seed);
+            statement1->setUInt64(16, simulationParameters.SweepPoint);
+            statement1->setUInt64(17, simulationParameters.Redo);
             statement1->execute();
             s_Connection->commit();
 
@@ -18,6 +18,9 @@ create table SimulationFTTDMA(
     CWSNEfficiency double,
     EnergyRateWorking double,
     EnergyRateTransfer double,
+    Seed bigint unsigned,
+    SweepPoint bigint unsigned,
+    Redo bigint unsigned,
     primary key(SimulationID)
 );
 
@@ -55,6 +58,9 @@ create table SimulationRRTDMA(
     CWSNEfficiency double,
 	EnergyRateWorking double,
     EnergyRateTransfer double,
+    Seed bigint unsigned,
+    SweepPoint bigint unsigned,
+    Redo bigint unsigned,
     primary key(SimulationID)
 );
 
@@ -78,8 +84,8 @@ create table SensorNodeRRTDMA(
 );
 
 -- placeholder
-insert into SimulationFTTDMA values(0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
-insert into SimulationRRTDMA values(0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+insert into SimulationFTTDMA values(0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+insert into SimulationRRTDMA values(0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 
 select * from SimulationFTTDMA;
 select * from SimulationRRTDMA;
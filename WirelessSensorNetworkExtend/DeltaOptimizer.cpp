@@ -0,0 +1,131 @@
+#include "PCH.h"
+#include "DeltaOptimizer.h"
+
+namespace WSN
+{
+	std::string DeltaOptimizerTypeToString(DeltaOptimizerType type)
+	{
+		switch (type)
+		{
+		case DeltaOptimizerType::ParticleSwarm: return "ParticleSwarm";
+		case DeltaOptimizerType::Tree: return "Tree";
+		}
+
+		throw std::runtime_error("Unknown Delta Optimizer Type in DeltaOptimizerTypeToString!");
+		return "";
+	}
+
+	ParticleSwarmDeltaOptimizer::ParticleSwarmDeltaOptimizer(std::vector<Philox> particleRandoms, bool reduceSymmetry, LaneInstructionSet instructionSet)
+		: m_ParticleRandoms(std::move(particleRandoms)), m_ReduceSymmetry(reduceSymmetry), m_InstructionSet(instructionSet)
+	{
+	}
+
+	DeltaOptimization ParticleSwarmDeltaOptimizer::Optimize(const PWTree& tree)
+	{
+		const size_t nodeCount = tree.GetNodeCount();
+
+		// a batch of particles is one walk over the tree with a lane per particle
+		std::vector<double> laneScratch(tree.GetLaneScratchSize());
+		auto CalculatePWs = [&](std::span<const double* const> deltas, std::span<double> values)
+		{
+			tree.EvaluateLanes(deltas, values, laneScratch, m_InstructionSet);
+		};
+
+		// with the symmetry reduction, a particle holds the delta of every class, expanded to every node before the walk
+		std::vector<uint32_t> classes;
+		size_t dimensionCount = m_ReduceSymmetry ? tree.GetSymmetryClasses(classes) : nodeCount;
+
+		std::vector<double> expandedDeltas(PWTree::c_LaneCount * nodeCount);
+		std::vector<const double*> expandedPointers(PWTree::c_LaneCount);
+		auto CalculateClassPWs = [&](std::span<const double* const> classDeltas, std::span<double> values)
+		{
+			for (size_t lane = 0; lane < classDeltas.size(); lane++)
+			{
+				double* deltas = expandedDeltas.data() + lane * nodeCount;
+				for (size_t i = 0; i < nodeCount; i++)
+					deltas[i] = classDeltas[lane][classes[i]];
+				expandedPointers[lane] = deltas;
+			}
+
+			CalculatePWs(std::span<const double* const>(expandedPointers.data(), classDeltas.size()), values);
+		};
+
+		ParticleSwarmParameters parameters;
+		parameters.BatchSize = PWTree::c_LaneCount;
+
+		ParticleSwarm swarm(dimensionCount, m_ParticleRandoms, parameters);
+		if (m_ReduceSymmetry)
+		{
+			std::cout << "PSO over " << dimensionCount << " delta classes of " << nodeCount << " SNs\n";
+			swarm.Optimize(CalculateClassPWs);
+		}
+		else
+			swarm.Optimize(CalculatePWs);
+
+		std::span<const double> bestPosition = swarm.GetBestPosition();
+		DeltaOptimization optimization = { std::vector<double>(bestPosition.begin(), bestPosition.end()), swarm.GetBestValue() };
+		if (m_ReduceSymmetry)
+		{
+			optimization.Deltas.resize(nodeCount);
+			for (size_t i = 0; i < nodeCount; i++)
+				optimization.Deltas[i] = bestPosition[classes[i]];
+		}
+
+		return optimization;
+	}
+
+	DeltaOptimization TreeDeltaOptimizer::Optimize(const PWTree& tree)
+	{
+		DeltaOptimization optimization;
+		optimization.Deltas.resize(tree.GetNodeCount());
+
+		std::vector<double> CWs(tree.GetNodeCount());
+		for (size_t p = 0; p < tree.GetNodeCount(); p++)
+		{
+			double childrenCW = tree.GetChildrenCW(p, CWs);
+			double delta = SearchDelta(tree, childrenCW);
+
+			optimization.Deltas[tree.GetSNID(p)] = delta;
+			CWs[p] = tree.GetCW(delta, childrenCW);
+		}
+
+		optimization.BSTotal = tree.Evaluate(optimization.Deltas, CWs);
+		return optimization;
+	}
+
+	double TreeDeltaOptimizer::SearchDelta(const PWTree& tree, double childrenCW)
+	{
+		static const double invPhi = (std::sqrt(5.0) - 1.0) / 2.0;
+
+		auto CW = [&](double logDelta) { return tree.GetCW(std::exp(logDelta), childrenCW); };
+
+		double low = c_MinLogDelta;
+		double high = c_MaxLogDelta;
+		double x1 = high - invPhi * (high - low);
+		double x2 = low + invPhi * (high - low);
+		double CW1 = CW(x1);
+		double CW2 = CW(x2);
+
+		while (high - low > c_LogDeltaTolerance)
+		{
+			if (CW1 < CW2)
+			{
+				low = x1;
+				x1 = x2;
+				CW1 = CW2;
+				x2 = low + invPhi * (high - low);
+				CW2 = CW(x2);
+			}
+			else
+			{
+				high = x2;
+				x2 = x1;
+				CW2 = CW1;
+				x1 = high - invPhi * (high - low);
+				CW1 = CW(x1);
+			}
+		}
+
+		return std::exp((low + high) / 2.0);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "PWTree.h"
+#include "ParticleSwarm.h"
+
+namespace WSN
+{
+	enum class DeltaOptimizerType
+	{
+		ParticleSwarm = 0,
+		Tree
+	};
+
+	std::string DeltaOptimizerTypeToString(DeltaOptimizerType type);
+
+	struct DeltaOptimization
+	{
+		// delta of every sensor node, by SNID
+		std::vector<double> Deltas;
+		// PWTree::Evaluate() of Deltas
+		double BSTotal = 0;
+	};
+
+	/// <summary>
+	/// Chooses the delta of every sensor node to maximize the steady state PW of the routing tree
+	/// </summary>
+	class DeltaOptimizer
+	{
+	public:
+		virtual ~DeltaOptimizer() = default;
+
+		virtual DeltaOptimization Optimize(const PWTree& tree) = 0;
+	};
+
+	/// <summary>
+	/// Particle swarm over all the deltas at once, a batch of particles is evaluated in one lane walk over the tree.
+	/// With reduceSymmetry, the swarm only has one delta per class of isomorphic subtrees (PWTree::GetSymmetryClasses()),
+	/// which keeps the optimum and divides the dimension by the redundancy of the tree.
+	/// </summary>
+	class ParticleSwarmDeltaOptimizer : public DeltaOptimizer
+	{
+	public:
+		/// <param name="particleRandoms">Stream of every particle, their count is the particle count</param>
+		ParticleSwarmDeltaOptimizer(std::vector<Philox> particleRandoms, bool reduceSymmetry = false, LaneInstructionSet instructionSet = GetLaneInstructionSet());
+
+		DeltaOptimization Optimize(const PWTree& tree) override;
+
+	private:
+		std::vector<Philox> m_ParticleRandoms;
+		bool m_ReduceSymmetry;
+		LaneInstructionSet m_InstructionSet;
+	};
+
+	/// <summary>
+	/// Exact bottom-up optimizer. The CW of a node only depends on its delta and on the sum of the CWs of its children, and it increases with
+	/// that sum, so maximizing every subtree on its own maximizes the whole tree. Every node is then a 1-D golden section search of its delta,
+	/// children first, in one pass over the tree.
+	/// </summary>
+	class TreeDeltaOptimizer : public DeltaOptimizer
+	{
+	public:
+		DeltaOptimization Optimize(const PWTree& tree) override;
+
+	private:
+		// the search is over log(delta), where the CW of a node is unimodal
+		static constexpr double c_MinLogDelta = -14.0;
+		static constexpr double c_MaxLogDelta = 28.0;
+		static constexpr double c_LogDeltaTolerance = 1e-10;
+
+		/// <summary>
+		/// delta maximizing tree.GetCW(delta, childrenCW)
+		/// </summary>
+		static double SearchDelta(const PWTree& tree, double childrenCW);
+	};
+}
@@ -1,12 +1,11 @@
 #include "PCH.h"
 
 #include "Distribution.h"
+#include "Samplers.h"
 
 
 namespace WSN
 {
-	std::mt19937_64 s_RNG(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-
 	static double FunctionWeibull(double xCurrent, double target)
 	{
 		return std::tgammal(1 + 2 / xCurrent) / (std::tgammal(1 + 1 / xCurrent) * std::tgammal(1 + 1 / xCurrent)) - target;
@@ -170,48 +169,34 @@ namespace WSN
 
 	}
 
-	double Distribution::GenerateRandomNumber()
+	double Distribution::GenerateRandomNumber(Philox& rng)
 	{
-		switch (m_DistributionType)
-		{
-		case DistributionType::Exponential:
-			return (*(std::exponential_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Gamma:
-			return (*(std::gamma_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Lognormal:
-			return (*(std::lognormal_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Weibull:
-			return (*(std::weibull_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Normal:
-			return (*(std::normal_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Uniform:
-			return (*(std::uniform_real_distribution<double>*)m_Distribution)(s_RNG);
-		}
-
-		throw std::runtime_error("Unknown Distribution Type in Distribution::GenerateRandomNumber");
-		return 0;
+		double value;
+		GenerateRandomNumbers(rng, { &value, 1 });
+		return value;
 	}
 
-	double Distribution::GenerateRandomNumber(std::mt19937_64& rng)
+	void Distribution::GenerateRandomNumbers(Philox& rng, std::span<double> values)
 	{
 		switch (m_DistributionType)
 		{
 		case DistributionType::Exponential:
-			return (*(std::exponential_distribution<double>*)m_Distribution)(rng);
+			return SampleExponential(rng, m_Parameter1, values);
 		case DistributionType::Gamma:
-			return (*(std::gamma_distribution<double>*)m_Distribution)(rng);
+			return SampleGamma(rng, m_Parameter1, m_Parameter2, values);
 		case DistributionType::Lognormal:
-			return (*(std::lognormal_distribution<double>*)m_Distribution)(rng);
+			return SampleLognormal(rng, m_Parameter1, m_Parameter2, values);
 		case DistributionType::Weibull:
-			return (*(std::weibull_distribution<double>*)m_Distribution)(rng);
+			return SampleWeibull(rng, m_Parameter1, m_Parameter2, values);
 		case DistributionType::Normal:
-			return (*(std::normal_distribution<double>*)m_Distribution)(rng);
+			return SampleNormal(rng, m_Parameter1, m_Parameter2, values);
 		case DistributionType::Uniform:
-			return (*(std::uniform_real_distribution<double>*)m_Distribution)(rng);
+			for (double& value : values)
+				value = (*(std::uniform_real_distribution<double>*)m_Distribution)(rng);
+			return;
 		}
 
-		throw std::runtime_error("Unknown Distribution Type in Distribution::GenerateRandomNumber");
-		return 0;
+		throw std::runtime_error("Unknown Distribution Type in Distribution::GenerateRandomNumbers");
 	}
 
 
@@ -1,9 +1,8 @@
 #pragma once
+#include "Philox.h"
 
 namespace WSN
 {
-	extern std::mt19937_64 s_RNG;
-
 	enum class DistributionType
 	{
 		Exponential = 0,
@@ -23,8 +22,13 @@ namespace WSN
 		Distribution(const Distribution& other);
 		~Distribution();
 
-		double GenerateRandomNumber();
-		double GenerateRandomNumber(std::mt19937_64& rng);
+		double GenerateRandomNumber(Philox& rng);
+
+		/// <summary>
+		/// Fills values through the batch samplers of Samplers.h (std::uniform_real_distribution for Uniform)
+		/// </summary>
+		void GenerateRandomNumbers(Philox& rng, std::span<double> values);
+
 		std::map<long long, long long> GetCDF();
 
 		void* m_Distribution;
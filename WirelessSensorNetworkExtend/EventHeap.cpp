@@ -0,0 +1,104 @@
+#include "PCH.h"
+#include "EventHeap.h"
+
+namespace WSN
+{
+	EventHeap::EventHeap(size_t nodeCount)
+		: m_States(nodeCount), m_Positions(nodeCount, c_None)
+	{
+		m_Heap.reserve(nodeCount);
+	}
+
+	void EventHeap::Update(const WorkingStateTimestamp& event)
+	{
+		const Key key = { event.Timestamp, event.SNID };
+		m_States[event.SNID] = event.State;
+
+		size_t index = m_Positions[event.SNID];
+		if (index == c_None)
+		{
+			m_Heap.push_back(key);
+			SiftUp(m_Heap.size() - 1, key);
+		}
+		else if (Before(key, m_Heap[index]))
+			SiftUp(index, key);
+		else
+			SiftDown(index, key);
+	}
+
+	void EventHeap::Pop()
+	{
+		Remove(m_Heap.front().SNID);
+	}
+
+	void EventHeap::Remove(uint64_t SNID)
+	{
+		size_t index = m_Positions[SNID];
+		m_Positions[SNID] = c_None;
+
+		Key last = m_Heap.back();
+		m_Heap.pop_back();
+		if (index == m_Heap.size())
+			return;
+
+		// the last key fills the hole, wherever it has to go from there
+		if (index > 0 && Before(last, m_Heap[(index - 1) / c_Arity]))
+			SiftUp(index, last);
+		else
+			SiftDown(index, last);
+	}
+
+	// both sifts move a hole instead of swapping, key is only written once its place is found
+
+	void EventHeap::SiftUp(size_t index, Key key)
+	{
+		while (index > 0)
+		{
+			size_t parent = (index - 1) / c_Arity;
+			if (!Before(key, m_Heap[parent]))
+				break;
+
+			Place(index, m_Heap[parent]);
+			index = parent;
+		}
+
+		Place(index, key);
+	}
+
+	void EventHeap::SiftDown(size_t index, Key key)
+	{
+		static_assert(c_Arity == 4, "The earliest of the children is picked as a tournament of 4!");
+
+		const size_t size = m_Heap.size();
+		while (true)
+		{
+			size_t firstChild = index * c_Arity + 1;
+			if (firstChild >= size)
+				break;
+
+			size_t best;
+			if (firstChild + c_Arity <= size)
+			{
+				const Key* children = &m_Heap[firstChild];
+				size_t best01 = Before(children[1], children[0]) ? 1 : 0;
+				size_t best23 = Before(children[3], children[2]) ? 3 : 2;
+				best = firstChild + (Before(children[best23], children[best01]) ? best23 : best01);
+			}
+			else
+			{
+				best = firstChild;
+				for (size_t child = firstChild + 1; child < size; child++)
+					if (Before(m_Heap[child], m_Heap[best]))
+						best = child;
+			}
+
+			if (!Before(m_Heap[best], key))
+				break;
+
+			Place(index, m_Heap[best]);
+			index = best;
+		}
+
+		Place(index, key);
+	}
+}
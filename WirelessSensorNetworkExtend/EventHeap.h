@@ -0,0 +1,75 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace WSN
+{
+	struct WorkingStateTimestamp
+	{
+		uint64_t SNID;
+		WorkingState State;
+		double Timestamp;
+	};
+
+	/// <summary>
+	/// Indexed 4-ary min-heap holding at most one pending event per sensor node. The earliest Timestamp comes first,
+	/// ties go to the larger SNID. The position of every node is tracked, so its event is rescheduled in place
+	/// (one sift) instead of a pop and a push.
+	/// </summary>
+	class EventHeap
+	{
+	public:
+		EventHeap(size_t nodeCount);
+
+		inline WorkingStateTimestamp Top() const { return { m_Heap.front().SNID, m_States[m_Heap.front().SNID], m_Heap.front().Timestamp }; }
+		inline bool Empty() const { return m_Heap.empty(); }
+		inline size_t Size() const { return m_Heap.size(); }
+
+		/// <summary>
+		/// Schedules event for event.SNID, replacing its pending event if it has one
+		/// </summary>
+		void Update(const WorkingStateTimestamp& event);
+
+		/// <summary>
+		/// Removes the pending event of the top node
+		/// </summary>
+		void Pop();
+
+		inline bool Contains(uint64_t SNID) const { return m_Positions[SNID] != c_None; }
+
+		/// <summary>
+		/// Removes the pending event of SNID, which must have one
+		/// </summary>
+		void Remove(uint64_t SNID);
+
+	private:
+		static constexpr size_t c_Arity = 4;
+		static constexpr size_t c_None = ~(size_t)0;
+
+		// the heap only holds the ordering key, the states are kept per node
+		struct Key
+		{
+			double Timestamp;
+			uint64_t SNID;
+		};
+
+		// without short circuits, so that picking the earliest child compiles to conditional moves
+		static inline bool Before(const Key& left, const Key& right)
+		{
+			return (left.Timestamp < right.Timestamp) | ((left.Timestamp == right.Timestamp) & (left.SNID > right.SNID));
+		}
+
+		void SiftUp(size_t index, Key key);
+		void SiftDown(size_t index, Key key);
+
+		inline void Place(size_t index, const Key& key)
+		{
+			m_Heap[index] = key;
+			m_Positions[key.SNID] = index;
+		}
+
+		std::vector<Key> m_Heap;
+		std::vector<WorkingState> m_States;
+		// index in m_Heap of the event of every node, c_None without one
+		std::vector<size_t> m_Positions;
+	};
+}
@@ -0,0 +1,97 @@
+#include "PCH.h"
+#include "EventScheduler.h"
+
+namespace WSN
+{
+	TimingWheelScheduler::TimingWheelScheduler(size_t nodeCount, double slotDuration)
+		: m_SlotDuration(slotDuration), m_Sequences(nodeCount, 0), m_Heap(nodeCount)
+	{
+	}
+
+	WorkingStateTimestamp TimingWheelScheduler::Top()
+	{
+		// an aligned event of slot s is within half a slot of s * m_SlotDuration, the slot is released once that could precede the heap top
+		while (m_WheelEntryCount > 0 && (m_Heap.Empty() || (m_CurrentSlot - 0.5) * m_SlotDuration <= m_Heap.Top().Timestamp))
+			AdvanceSlot();
+
+		return m_Heap.Top();
+	}
+
+	void TimingWheelScheduler::Update(const WorkingStateTimestamp& event)
+	{
+		const uint64_t sequence = ++m_Sequences[event.SNID];
+
+		uint64_t slot;
+		if (!GetSlot(event.Timestamp, slot) || slot < m_CurrentSlot || (slot ^ m_CurrentSlot) >> (c_LevelBits * c_LevelCount) != 0)
+		{
+			m_Heap.Update(event);
+			return;
+		}
+
+		if (m_Heap.Contains(event.SNID))
+			m_Heap.Remove(event.SNID);
+
+		Insert({ event, sequence, slot });
+	}
+
+	bool TimingWheelScheduler::GetSlot(double timestamp, uint64_t& slot) const
+	{
+		// slot boundaries are accumulated in InnerRun, so they are only matched up to rounding
+		double slots = std::round(timestamp / m_SlotDuration);
+		if (slots < 0 || std::abs(timestamp - slots * m_SlotDuration) > 1e-9 * std::max(timestamp, m_SlotDuration))
+			return false;
+
+		slot = (uint64_t)slots;
+		return true;
+	}
+
+	void TimingWheelScheduler::Insert(const Entry& entry)
+	{
+		// the lowest level whose current bucket span also holds the slot
+		int level = 0;
+		while ((entry.Slot ^ m_CurrentSlot) >> (c_LevelBits * (level + 1)) != 0)
+			level++;
+
+		m_Buckets[level][(entry.Slot >> (c_LevelBits * level)) & (c_SlotsPerBucket - 1)].push_back(entry);
+		m_WheelEntryCount++;
+	}
+
+	void TimingWheelScheduler::Cascade(int level)
+	{
+		// every entry of the bucket lies in the span just entered, so none of them lands back in it
+		std::vector<Entry>& bucket = m_Buckets[level][(m_CurrentSlot >> (c_LevelBits * level)) & (c_SlotsPerBucket - 1)];
+		m_WheelEntryCount -= bucket.size();
+
+		for (const Entry& entry : bucket)
+		{
+			if (entry.Sequence == m_Sequences[entry.Event.SNID])
+				Insert(entry);
+		}
+
+		bucket.clear();
+	}
+
+	void TimingWheelScheduler::AdvanceSlot()
+	{
+		std::vector<Entry>& bucket = m_Buckets[0][m_CurrentSlot & (c_SlotsPerBucket - 1)];
+		for (const Entry& entry : bucket)
+			if (entry.Sequence == m_Sequences[entry.Event.SNID])
+				m_Heap.Update(entry.Event);
+		m_WheelEntryCount -= bucket.size();
+		bucket.clear();
+
+		m_CurrentSlot++;
+
+		// entering a new span of a level, its bucket is spread over the levels below, from the top down
+		for (int level = c_LevelCount - 1; level > 0; level--)
+			if ((m_CurrentSlot & ((1ull << (c_LevelBits * level)) - 1)) == 0)
+				Cascade(level);
+	}
+
+	EventScheduler::EventScheduler(EventSchedulerType type, size_t nodeCount, double slotDuration)
+		: m_Type(type), m_Heap(type == EventSchedulerType::Heap ? nodeCount : 0)
+	{
+		if (type == EventSchedulerType::TimingWheel)
+			m_TimingWheel = std::make_unique<TimingWheelScheduler>(nodeCount, slotDuration);
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "EventHeap.h"
+
+namespace WSN
+{
+	enum class EventSchedulerType
+	{
+		Heap = 0,
+		TimingWheel
+	};
+
+	/// <summary>
+	/// Event queue bucketed by TDMA slot. Collections and transfers start on slot boundaries (multiples of slotDuration),
+	/// they are put in O(1) in a hierarchical timing wheel of 3 levels of 256 slots. Only the off-grid events (failures and
+	/// the ends of recoveries) and the events of the slots that are due go through a side heap, which keeps the exact order of EventHeap.
+	/// </summary>
+	class TimingWheelScheduler
+	{
+	public:
+		TimingWheelScheduler(size_t nodeCount, double slotDuration);
+
+		/// <summary>
+		/// Earliest pending event, the wheel releases into the side heap every slot that could come before it
+		/// </summary>
+		WorkingStateTimestamp Top();
+
+		/// <summary>
+		/// Schedules event for event.SNID, replacing its pending event if it has one
+		/// </summary>
+		void Update(const WorkingStateTimestamp& event);
+
+	private:
+		static constexpr int c_LevelBits = 8;
+		static constexpr int c_LevelCount = 3;
+		static constexpr uint64_t c_SlotsPerBucket = 1 << c_LevelBits;
+
+		// rescheduling a node bumps its sequence, entries left behind in the wheel are dropped once released
+		struct Entry
+		{
+			WorkingStateTimestamp Event;
+			uint64_t Sequence;
+			// computed once in Update, cascading reuses it
+			uint64_t Slot;
+		};
+
+		// slot of a timestamp on a slot boundary, false for off-grid timestamps
+		bool GetSlot(double timestamp, uint64_t& slot) const;
+
+		void Insert(const Entry& entry);
+		void Cascade(int level);
+
+		/// <summary>
+		/// Releases the bucket of m_CurrentSlot into the side heap and moves to the next slot
+		/// </summary>
+		void AdvanceSlot();
+
+		double m_SlotDuration;
+		// every slot before it is already released into the side heap
+		uint64_t m_CurrentSlot = 0;
+		uint64_t m_WheelEntryCount = 0;
+
+		std::vector<Entry> m_Buckets[c_LevelCount][c_SlotsPerBucket];
+		std::vector<uint64_t> m_Sequences;
+
+		EventHeap m_Heap;
+	};
+
+	/// <summary>
+	/// Runtime choice between EventHeap and TimingWheelScheduler behind the interface of InnerRun, both give the same order
+	/// </summary>
+	class EventScheduler
+	{
+	public:
+		EventScheduler(EventSchedulerType type, size_t nodeCount, double slotDuration);
+
+		inline WorkingStateTimestamp Top() { return m_Type == EventSchedulerType::Heap ? m_Heap.Top() : m_TimingWheel->Top(); }
+
+		inline void Update(const WorkingStateTimestamp& event)
+		{
+			if (m_Type == EventSchedulerType::Heap)
+				m_Heap.Update(event);
+			else
+				m_TimingWheel->Update(event);
+		}
+
+	private:
+		EventSchedulerType m_Type;
+		EventHeap m_Heap;
+		std::unique_ptr<TimingWheelScheduler> m_TimingWheel;
+	};
+}
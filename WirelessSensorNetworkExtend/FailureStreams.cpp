@@ -0,0 +1,29 @@
+#include "PCH.h"
+#include "FailureStreams.h"
+
+namespace WSN
+{
+	FailureStreams::FailureStreams(Distribution& distribution, std::vector<Philox> randoms)
+		: m_Distribution(distribution), m_Streams(randoms.size())
+	{
+		for (size_t i = 0; i < randoms.size(); i++)
+			m_Streams[i].Random = randoms[i];
+	}
+
+	void FailureStreams::Generate(SNStream& stream, size_t index)
+	{
+		double currentTime = stream.Timestamps.empty() ? 0 : stream.Timestamps.back();
+		while (stream.Timestamps.size() <= index)
+		{
+			if (stream.IntervalIterator == stream.Intervals.size())
+			{
+				stream.Intervals.resize(c_BatchSize);
+				m_Distribution.GenerateRandomNumbers(stream.Random, stream.Intervals);
+				stream.IntervalIterator = 0;
+			}
+
+			currentTime += stream.Intervals[stream.IntervalIterator++];
+			stream.Timestamps.push_back(currentTime);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Distribution.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Failure timestamps of every sensor node, drawn from the Philox stream of the node only as simulation time reaches them.
+	/// They are memoized, so that every SimulationType run of a Simulation replays the same failures without drawing them again.
+	/// </summary>
+	class FailureStreams
+	{
+	public:
+		static constexpr size_t c_BatchSize = 256;
+
+		/// <param name="distribution">Failure interval distribution, must outlive the streams</param>
+		/// <param name="randoms">Stream of every sensor node, indexed by SNID</param>
+		FailureStreams(Distribution& distribution, std::vector<Philox> randoms);
+
+		/// <summary>
+		/// index-th failure timestamp of SNID, generated on demand
+		/// </summary>
+		inline double Get(uint64_t SNID, size_t index)
+		{
+			SNStream& stream = m_Streams[SNID];
+			if (index >= stream.Timestamps.size())
+				Generate(stream, index);
+			return stream.Timestamps[index];
+		}
+
+	private:
+		struct SNStream
+		{
+			Philox Random;
+			// intervals are drawn a batch at a time
+			std::vector<double> Intervals;
+			size_t IntervalIterator = 0;
+			std::vector<double> Timestamps;
+		};
+
+		void Generate(SNStream& stream, size_t index);
+
+		Distribution& m_Distribution;
+		std::vector<SNStream> m_Streams;
+	};
+}
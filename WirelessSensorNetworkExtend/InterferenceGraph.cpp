@@ -0,0 +1,81 @@
+#include "PCH.h"
+#include "InterferenceGraph.h"
+#include "SpatialGrid.h"
+
+namespace WSN
+{
+	InterferenceGraph::InterferenceGraph(const std::vector<SensorNode>& sensorNodes, double interferenceRange)
+	{
+		std::vector<uint64_t> SNIDs(sensorNodes.size());
+		for (uint64_t i = 0; i < SNIDs.size(); i++)
+			SNIDs[i] = i;
+		SpatialGrid grid(sensorNodes, SNIDs);
+
+		m_Offsets.reserve(sensorNodes.size() + 1);
+		m_Offsets.push_back(0);
+
+		std::vector<uint64_t> neighbors;
+		for (uint64_t i = 0; i < sensorNodes.size(); i++)
+		{
+			grid.WithinRadius(sensorNodes[i].m_Position, interferenceRange, neighbors);
+			std::sort(neighbors.begin(), neighbors.end());
+			for (uint64_t neighbor : neighbors)
+				if (neighbor != i)
+					m_Neighbors.push_back(neighbor);
+			m_Offsets.push_back(m_Neighbors.size());
+		}
+	}
+
+	std::vector<uint64_t> InterferenceGraph::ColorDSATUR() const
+	{
+		const size_t nodeCount = GetNodeCount();
+		std::vector<uint64_t> colors(nodeCount, 0);
+
+		// a node never needs more colors than its degree + 1, so that many bits cover the colors of its neighbors
+		size_t maxDegree = 0;
+		for (uint64_t i = 0; i < nodeCount; i++)
+			maxDegree = std::max(maxDegree, GetDegree(i));
+		const size_t wordCount = maxDegree / 64 + 1;
+
+		std::vector<uint64_t> neighborColors(nodeCount * wordCount, 0);
+		std::vector<uint64_t> saturations(nodeCount, 0);
+
+		// uncolored nodes as (saturation, degree, ~SNID), the last one is colored next
+		std::set<std::tuple<uint64_t, uint64_t, uint64_t>> uncolored;
+		for (uint64_t i = 0; i < nodeCount; i++)
+			uncolored.insert({ 0, GetDegree(i), ~i });
+
+		while (!uncolored.empty())
+		{
+			const uint64_t SNID = ~std::get<2>(*uncolored.rbegin());
+			uncolored.erase(std::prev(uncolored.end()));
+
+			const uint64_t* words = &neighborColors[SNID * wordCount];
+			uint64_t color = 0;
+			for (size_t word = 0; word < wordCount; word++)
+			{
+				if (~words[word] != 0)
+				{
+					color = word * 64 + std::countr_zero(~words[word]);
+					break;
+				}
+			}
+			colors[SNID] = color;
+
+			for (uint64_t neighbor : GetNeighbors(SNID))
+			{
+				uint64_t& word = neighborColors[neighbor * wordCount + color / 64];
+				const uint64_t bit = 1ull << (color % 64);
+				if (word & bit)
+					continue;
+				word |= bit;
+
+				// colored neighbors are no longer in the set, their saturation does not matter anymore
+				if (uncolored.erase({ saturations[neighbor], GetDegree(neighbor), ~neighbor }))
+					uncolored.insert({ ++saturations[neighbor], GetDegree(neighbor), ~neighbor });
+			}
+		}
+
+		return colors;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Pairs of sensor nodes within interference range of each other, as CSR adjacency built from SpatialGrid radius queries
+	/// </summary>
+	class InterferenceGraph
+	{
+	public:
+		InterferenceGraph(const std::vector<SensorNode>& sensorNodes, double interferenceRange);
+
+		inline size_t GetNodeCount() const { return m_Offsets.size() - 1; }
+		inline size_t GetDegree(uint64_t SNID) const { return m_Offsets[SNID + 1] - m_Offsets[SNID]; }
+		inline std::span<const uint64_t> GetNeighbors(uint64_t SNID) const { return { m_Neighbors.data() + m_Offsets[SNID], GetDegree(SNID) }; }
+
+		/// <summary>
+		/// DSATUR coloring : the uncolored node seeing the most distinct neighbor colors (then the highest degree, then the smallest SNID)
+		/// takes the smallest color none of its neighbors has. Returns the color of every node, colors are 0, 1, ...
+		/// </summary>
+		std::vector<uint64_t> ColorDSATUR() const;
+
+	private:
+		// the neighbors of node i are m_Neighbors[m_Offsets[i], m_Offsets[i + 1]), sorted
+		std::vector<size_t> m_Offsets;
+		std::vector<uint64_t> m_Neighbors;
+	};
+}
@@ -11,8 +11,25 @@ static constexpr double s_TotalDurationToBeTransferred = 3600.0 * 24 * 90;
 //static constexpr double s_TransferTime = 60;
 static constexpr double s_RecoveryTime = 30;
 
+// master seed of every simulation, 0 draws one from the clock. It is printed and saved with every simulation, setting it here reproduces a run
+static constexpr uint64_t s_Seed = 0;
+
+// event queue of the simulator, both give the same results
+static constexpr WSN::EventSchedulerType s_EventScheduler = WSN::EventSchedulerType::Heap;
+
+// optimizer of the deltas of the sensor nodes, Tree is exact and takes a single pass over the routing tree. Comparing also runs the other one and prints both PWs
+static constexpr WSN::DeltaOptimizerType s_DeltaOptimizer = WSN::DeltaOptimizerType::ParticleSwarm;
+static constexpr bool s_CompareDeltaOptimizers = false;
+// the PSO searches one delta per class of isomorphic subtrees instead of one per sensor node, same optimum in far fewer dimensions
+static constexpr bool s_ReduceDeltaSymmetry = false;
+
 int main()
 {
+	const uint64_t seed = s_Seed != 0 ? s_Seed : std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	std::cout << "Seed = " << seed << '\n';
+
+	// position of the simulation in the sweep, keys its random streams along with the redo
+	uint64_t sweepPoint = 0;
 
 	std::vector<double> interferenceRanges =
 	{
@@ -86,6 +103,7 @@ int main()
 
 	for (int redo = 0; redo < 1; redo++)
 	{
+		sweepPoint = 0;
 		//for (double transferTime = 30; transferTime <= 30 * 1001; transferTime *= 10)
 		//for (double transferTime = 30; transferTime <= 30 * 50 * 50 * 51; transferTime *= 50)
 		for (auto& transferTime : transferTimes)
@@ -162,6 +180,13 @@ int main()
 												200,
 												interferenceRange
 											};
+											sp.Seed = seed;
+											sp.SweepPoint = sweepPoint++;
+											sp.Redo = redo;
+											sp.EventScheduler = s_EventScheduler;
+											sp.DeltaOptimizer = s_DeltaOptimizer;
+											sp.CompareDeltaOptimizers = s_CompareDeltaOptimizers;
+											sp.ReduceDeltaSymmetry = s_ReduceDeltaSymmetry;
 
 											WSN::Simulation* Si = new WSN::Simulation(sp);
 
@@ -13,4 +13,15 @@
 #include <memory>
 #include <sstream>
 #include <queue>
-#include <utility>
\ No newline at end of file
+#include <utility>
+#include <algorithm>
+#include <span>
+#include <set>
+#include <bit>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <exception>
\ No newline at end of file
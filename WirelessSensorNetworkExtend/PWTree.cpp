@@ -0,0 +1,319 @@
+#include "PCH.h"
+#include "PWTree.h"
+#include "ThreadPool.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define WSN_LANES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WSN_TARGET_AVX2
+#define WSN_TARGET_AVX512
+#else
+#include <immintrin.h>
+#define WSN_TARGET_AVX2 __attribute__((target("avx2")))
+#define WSN_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace WSN
+{
+	static LaneInstructionSet DetectLaneInstructionSet()
+	{
+#if WSN_LANES_X86
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return LaneInstructionSet::Scalar;
+
+		__cpuid(info, 1);
+		bool osxsave = info[2] & (1 << 27);
+		if (!osxsave)
+			return LaneInstructionSet::Scalar;
+
+		// the OS has to save the ymm (and zmm) registers as well
+		unsigned long long xcr0 = _xgetbv(0);
+
+		__cpuidex(info, 7, 0);
+		bool avx2 = info[1] & (1 << 5);
+		bool avx512f = info[1] & (1 << 16);
+
+		if (avx512f && (xcr0 & 0xE6) == 0xE6)
+			return LaneInstructionSet::AVX512;
+		if (avx2 && (xcr0 & 0x6) == 0x6)
+			return LaneInstructionSet::AVX2;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return LaneInstructionSet::AVX512;
+		if (__builtin_cpu_supports("avx2"))
+			return LaneInstructionSet::AVX2;
+#endif
+#endif
+		return LaneInstructionSet::Scalar;
+	}
+
+	LaneInstructionSet GetLaneInstructionSet()
+	{
+		static LaneInstructionSet instructionSet = DetectLaneInstructionSet();
+		return instructionSet;
+	}
+
+	std::string LaneInstructionSetToString(LaneInstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case LaneInstructionSet::Scalar: return "Scalar";
+		case LaneInstructionSet::AVX2: return "AVX2";
+		case LaneInstructionSet::AVX512: return "AVX512";
+		}
+
+		throw std::runtime_error("Unknown Lane Instruction Set in LaneInstructionSetToString!");
+		return "";
+	}
+
+	double PWSteadyStateFunc(double selfDelta, double selfTau, double selfLambda, double selfReparationTime, double mu)
+	{
+		mu *= selfReparationTime + selfDelta / 2.0;
+
+		return 1.0 / (1.0 + (selfTau / selfDelta) + (mu / selfLambda));
+	}
+
+	PWTree::PWTree(const std::vector<SensorNode>& sensorNodes, size_t levelCount, double transferTime, double failureMean, double recoveryTime)
+		: m_TransferTime(transferTime), m_FailureMean(failureMean), m_RecoveryTime(recoveryTime)
+	{
+		for (int i = (int)levelCount - 1; i >= 0; i--)
+			for (uint64_t j = 0; j < sensorNodes.size(); j++)
+				if (sensorNodes[j].m_Level == i)
+					m_SNIDs.push_back(j);
+
+		// root of every node, parents come after their children so they are visited first backwards
+		std::vector<uint64_t> roots(sensorNodes.size());
+		for (auto it = m_SNIDs.rbegin(); it != m_SNIDs.rend(); it++)
+		{
+			if (sensorNodes[*it].m_Parent == -2)
+				throw std::runtime_error("An SN does not have any parents !");
+
+			roots[*it] = sensorNodes[*it].m_Parent == -1 ? *it : roots[sensorNodes[*it].m_Parent];
+		}
+
+		// every subtree of a root becomes a contiguous range, still deepest level first within it
+		std::stable_sort(m_SNIDs.begin(), m_SNIDs.end(), [&](uint64_t a, uint64_t b) { return roots[a] < roots[b]; });
+
+		// the subtrees are grouped into chunks of about the same node count, a few per thread so that they balance out
+		const size_t chunkTarget = std::max(c_MinChunkNodeCount, m_SNIDs.size() / (4 * (ThreadPool::Get().GetThreadCount() + 1)));
+		m_ChunkOffsets.push_back(0);
+		for (size_t p = 1; p <= m_SNIDs.size(); p++)
+			if (p == m_SNIDs.size() || (roots[m_SNIDs[p]] != roots[m_SNIDs[p - 1]] && p - m_ChunkOffsets.back() >= chunkTarget))
+				m_ChunkOffsets.push_back(p);
+
+		std::vector<uint32_t> positions(sensorNodes.size());
+		for (size_t p = 0; p < m_SNIDs.size(); p++)
+			positions[m_SNIDs[p]] = (uint32_t)p;
+
+		// counting sort of the children by parent, SNIDs are visited in order so every parent keeps its children by SNID
+		m_ChildOffsets.assign(m_SNIDs.size() + 1, 0);
+		for (uint64_t i = 0; i < sensorNodes.size(); i++)
+			if (sensorNodes[i].m_Parent != -1)
+				m_ChildOffsets[positions[sensorNodes[i].m_Parent] + 1]++;
+		for (size_t p = 0; p < m_SNIDs.size(); p++)
+			m_ChildOffsets[p + 1] += m_ChildOffsets[p];
+
+		m_ChildPositions.resize(m_ChildOffsets.back());
+		std::vector<size_t> childEnds(m_ChildOffsets.begin(), m_ChildOffsets.end() - 1);
+		for (uint64_t i = 0; i < sensorNodes.size(); i++)
+		{
+			if (sensorNodes[i].m_Parent == -1)
+				m_RootPositions.push_back(positions[i]);
+			else
+				m_ChildPositions[childEnds[positions[sensorNodes[i].m_Parent]]++] = positions[i];
+		}
+	}
+
+	double PWTree::Evaluate(std::span<const double> deltas, std::span<double> CWs) const
+	{
+		for (size_t p = 0; p < m_SNIDs.size(); p++)
+		{
+			double mu = 1.0;
+			for (size_t k = m_ChildOffsets[p]; k < m_ChildOffsets[p + 1]; k++)
+				mu += CWs[m_ChildPositions[k]];
+
+			double CW = PWSteadyStateFunc(deltas[m_SNIDs[p]], m_TransferTime, m_FailureMean, m_RecoveryTime, mu);
+
+			for (size_t k = m_ChildOffsets[p]; k < m_ChildOffsets[p + 1]; k++)
+				CW += CWs[m_ChildPositions[k]];
+			CWs[p] = CW;
+		}
+
+		double BSTotal = 0.0;
+		for (uint32_t p : m_RootPositions)
+			BSTotal += CWs[p];
+
+		return BSTotal;
+	}
+
+	double PWTree::GetChildrenCW(size_t position, std::span<const double> CWs) const
+	{
+		double childrenCW = 0.0;
+		for (size_t k = m_ChildOffsets[position]; k < m_ChildOffsets[position + 1]; k++)
+			childrenCW += CWs[m_ChildPositions[k]];
+		return childrenCW;
+	}
+
+	uint32_t PWTree::GetSymmetryClasses(std::vector<uint32_t>& classes) const
+	{
+		classes.assign(m_SNIDs.size(), 0);
+
+		// a subtree is identified by the sorted classes of its children, the children always come before their parent
+		std::map<std::vector<uint32_t>, uint32_t> classOfChildren;
+		std::vector<uint32_t> positionClasses(m_SNIDs.size());
+		std::vector<uint32_t> childClasses;
+		for (size_t p = 0; p < m_SNIDs.size(); p++)
+		{
+			childClasses.clear();
+			for (size_t k = m_ChildOffsets[p]; k < m_ChildOffsets[p + 1]; k++)
+				childClasses.push_back(positionClasses[m_ChildPositions[k]]);
+			std::sort(childClasses.begin(), childClasses.end());
+
+			auto it = classOfChildren.try_emplace(childClasses, (uint32_t)classOfChildren.size()).first;
+			positionClasses[p] = it->second;
+			classes[m_SNIDs[p]] = it->second;
+		}
+
+		return (uint32_t)classOfChildren.size();
+	}
+
+	// The lane kernels follow Evaluate() operation by operation over the positions [begin, end), lane l of position p is [p * c_LaneCount + l] of deltas and CWs
+
+	static void EvaluateLanesScalar(size_t begin, size_t end, const size_t* childOffsets, const uint32_t* childPositions,
+		const double* deltas, double* CWs, double tau, double lambda, double reparationTime)
+	{
+		constexpr int laneCount = PWTree::c_LaneCount;
+
+		for (size_t p = begin; p < end; p++)
+		{
+			double mu[laneCount];
+			for (int lane = 0; lane < laneCount; lane++)
+				mu[lane] = 1.0;
+			for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+				for (int lane = 0; lane < laneCount; lane++)
+					mu[lane] += CWs[childPositions[k] * laneCount + lane];
+
+			double CW[laneCount];
+			for (int lane = 0; lane < laneCount; lane++)
+				CW[lane] = PWSteadyStateFunc(deltas[p * laneCount + lane], tau, lambda, reparationTime, mu[lane]);
+
+			for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+				for (int lane = 0; lane < laneCount; lane++)
+					CW[lane] += CWs[childPositions[k] * laneCount + lane];
+
+			for (int lane = 0; lane < laneCount; lane++)
+				CWs[p * laneCount + lane] = CW[lane];
+		}
+	}
+
+#if WSN_LANES_X86
+	WSN_TARGET_AVX2 static void EvaluateLanesAVX2(size_t begin, size_t end, const size_t* childOffsets, const uint32_t* childPositions,
+		const double* deltas, double* CWs, double tau, double lambda, double reparationTime)
+	{
+		constexpr int laneCount = PWTree::c_LaneCount;
+
+		const __m256d one = _mm256_set1_pd(1.0);
+		const __m256d two = _mm256_set1_pd(2.0);
+		const __m256d tauVector = _mm256_set1_pd(tau);
+		const __m256d lambdaVector = _mm256_set1_pd(lambda);
+		const __m256d reparationTimeVector = _mm256_set1_pd(reparationTime);
+
+		for (size_t p = begin; p < end; p++)
+		{
+			// two halves of 4 lanes
+			for (int offset = 0; offset < laneCount; offset += 4)
+			{
+				__m256d mu = one;
+				for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+					mu = _mm256_add_pd(mu, _mm256_loadu_pd(CWs + childPositions[k] * laneCount + offset));
+
+				const __m256d delta = _mm256_loadu_pd(deltas + p * laneCount + offset);
+				mu = _mm256_mul_pd(mu, _mm256_add_pd(reparationTimeVector, _mm256_div_pd(delta, two)));
+				__m256d CW = _mm256_div_pd(one, _mm256_add_pd(_mm256_add_pd(one, _mm256_div_pd(tauVector, delta)), _mm256_div_pd(mu, lambdaVector)));
+
+				for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+					CW = _mm256_add_pd(CW, _mm256_loadu_pd(CWs + childPositions[k] * laneCount + offset));
+
+				_mm256_storeu_pd(CWs + p * laneCount + offset, CW);
+			}
+		}
+	}
+
+	WSN_TARGET_AVX512 static void EvaluateLanesAVX512(size_t begin, size_t end, const size_t* childOffsets, const uint32_t* childPositions,
+		const double* deltas, double* CWs, double tau, double lambda, double reparationTime)
+	{
+		constexpr int laneCount = PWTree::c_LaneCount;
+		static_assert(laneCount == 8, "All the lanes fit in one zmm register!");
+
+		const __m512d one = _mm512_set1_pd(1.0);
+		const __m512d two = _mm512_set1_pd(2.0);
+		const __m512d tauVector = _mm512_set1_pd(tau);
+		const __m512d lambdaVector = _mm512_set1_pd(lambda);
+		const __m512d reparationTimeVector = _mm512_set1_pd(reparationTime);
+
+		for (size_t p = begin; p < end; p++)
+		{
+			__m512d mu = one;
+			for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+				mu = _mm512_add_pd(mu, _mm512_loadu_pd(CWs + childPositions[k] * laneCount));
+
+			const __m512d delta = _mm512_loadu_pd(deltas + p * laneCount);
+			mu = _mm512_mul_pd(mu, _mm512_add_pd(reparationTimeVector, _mm512_div_pd(delta, two)));
+			__m512d CW = _mm512_div_pd(one, _mm512_add_pd(_mm512_add_pd(one, _mm512_div_pd(tauVector, delta)), _mm512_div_pd(mu, lambdaVector)));
+
+			for (size_t k = childOffsets[p]; k < childOffsets[p + 1]; k++)
+				CW = _mm512_add_pd(CW, _mm512_loadu_pd(CWs + childPositions[k] * laneCount));
+
+			_mm512_storeu_pd(CWs + p * laneCount, CW);
+		}
+	}
+#endif
+
+	void PWTree::EvaluateLanes(std::span<const double* const> deltas, std::span<double> values, std::span<double> scratch, LaneInstructionSet instructionSet) const
+	{
+		const size_t nodeCount = GetNodeCount();
+		const int count = (int)deltas.size();
+		double* lanesDeltas = scratch.data();
+		double* lanesCWs = scratch.data() + nodeCount * c_LaneCount;
+
+		// a chunk only holds whole subtrees, so the chunks write disjoint positions and read nothing of each other
+		auto WalkChunk = [&](long long chunk)
+		{
+			const size_t begin = m_ChunkOffsets[chunk];
+			const size_t end = m_ChunkOffsets[chunk + 1];
+
+			for (size_t p = begin; p < end; p++)
+				for (int lane = 0; lane < c_LaneCount; lane++)
+					lanesDeltas[p * c_LaneCount + lane] = deltas[std::min(lane, count - 1)][m_SNIDs[p]];
+
+#if WSN_LANES_X86
+			if (instructionSet == LaneInstructionSet::AVX512)
+				EvaluateLanesAVX512(begin, end, m_ChildOffsets.data(), m_ChildPositions.data(), lanesDeltas, lanesCWs, m_TransferTime, m_FailureMean, m_RecoveryTime);
+			else if (instructionSet == LaneInstructionSet::AVX2)
+				EvaluateLanesAVX2(begin, end, m_ChildOffsets.data(), m_ChildPositions.data(), lanesDeltas, lanesCWs, m_TransferTime, m_FailureMean, m_RecoveryTime);
+			else
+#endif
+				EvaluateLanesScalar(begin, end, m_ChildOffsets.data(), m_ChildPositions.data(), lanesDeltas, lanesCWs, m_TransferTime, m_FailureMean, m_RecoveryTime);
+		};
+
+		const long long chunkCount = (long long)m_ChunkOffsets.size() - 1;
+		if (chunkCount == 1)
+			WalkChunk(0);
+		else
+			ThreadPool::Get().ParallelFor(chunkCount, WalkChunk);
+
+		for (int lane = 0; lane < count; lane++)
+		{
+			double BSTotal = 0.0;
+			for (uint32_t p : m_RootPositions)
+				BSTotal += lanesCWs[p * c_LaneCount + lane];
+			values[lane] = BSTotal;
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace WSN
+{
+	enum class LaneInstructionSet
+	{
+		Scalar,
+		AVX2,
+		AVX512
+	};
+
+	/// <summary>
+	/// Widest instruction set supported by both the build and the running CPU, detected once
+	/// </summary>
+	LaneInstructionSet GetLaneInstructionSet();
+
+	std::string LaneInstructionSetToString(LaneInstructionSet instructionSet);
+
+	// big parameters, i.e. durations instead of rates. mu is 1 + the sum of the PWs of the children
+	double PWSteadyStateFunc(double selfDelta, double selfTau, double selfLambda, double selfReparationTime, double mu);
+
+	/// <summary>
+	/// Routing tree of the sensor nodes flattened for the steady state PW : nodes in post-order with CSR children, so that every child is
+	/// evaluated before its parent in one pass over the nodes. The subtree of every root is a contiguous range (deepest level first, by SNID
+	/// within a level), the ranges are grouped in chunks that EvaluateLanes walks in parallel on the ThreadPool.
+	/// </summary>
+	class PWTree
+	{
+	public:
+		static constexpr int c_LaneCount = 8;
+		// below that many nodes a chunk is not worth handing to another thread
+		static constexpr size_t c_MinChunkNodeCount = 2048;
+
+		PWTree(const std::vector<SensorNode>& sensorNodes, size_t levelCount, double transferTime, double failureMean, double recoveryTime);
+
+		inline size_t GetNodeCount() const { return m_SNIDs.size(); }
+		inline size_t GetLaneScratchSize() const { return 2 * GetNodeCount() * c_LaneCount; }
+		inline uint64_t GetSNID(size_t position) const { return m_SNIDs[position]; }
+
+		/// <summary>
+		/// Sum of the CWs of the children of position, CWs by post-order position as Evaluate() fills them
+		/// </summary>
+		double GetChildrenCW(size_t position, std::span<const double> CWs) const;
+
+		/// <summary>
+		/// CW of a node for delta, given the sum of the CWs of its children. Increases with childrenCW for any delta
+		/// </summary>
+		inline double GetCW(double delta, double childrenCW) const
+		{
+			return PWSteadyStateFunc(delta, m_TransferTime, m_FailureMean, m_RecoveryTime, 1.0 + childrenCW) + childrenCW;
+		}
+
+		/// <summary>
+		/// Sum of the CWs of the nodes connected to the base station, deltas indexed by SNID. CWs is scratch of GetNodeCount(), by post-order position
+		/// </summary>
+		double Evaluate(std::span<const double> deltas, std::span<double> CWs) const;
+
+		/// <summary>
+		/// Puts every node in the class of its subtree up to isomorphism (AHU canonical form), numbered by first appearance in post-order.
+		/// The CW of a subtree only depends on its shape and deltas, so the nodes of a class share their optimal delta. Returns the class count
+		/// </summary>
+		uint32_t GetSymmetryClasses(std::vector<uint32_t>& classes) const;
+
+		/// <summary>
+		/// Evaluate() of up to c_LaneCount delta vectors at once in SoA layout, one lane each. The unused lanes repeat the last deltas.
+		/// scratch is of GetLaneScratchSize(), every lane gives the same result as Evaluate() whatever the thread count
+		/// </summary>
+		void EvaluateLanes(std::span<const double* const> deltas, std::span<double> values, std::span<double> scratch, LaneInstructionSet instructionSet) const;
+
+	private:
+		// SNID of every post-order position
+		std::vector<uint64_t> m_SNIDs;
+		// children of position p are m_ChildPositions[m_ChildOffsets[p], m_ChildOffsets[p + 1]), by SNID
+		std::vector<size_t> m_ChildOffsets;
+		std::vector<uint32_t> m_ChildPositions;
+		std::vector<uint32_t> m_RootPositions;
+		// chunk c is the positions [m_ChunkOffsets[c], m_ChunkOffsets[c + 1]), whole subtrees only
+		std::vector<size_t> m_ChunkOffsets;
+
+		double m_TransferTime;
+		double m_FailureMean;
+		double m_RecoveryTime;
+	};
+}
@@ -0,0 +1,57 @@
+#include "PCH.h"
+#include "PacketPool.h"
+
+namespace WSN
+{
+	uint32_t PacketPool::PushBack(PacketList& list, uint64_t initialSNID, double initialTimestamp)
+	{
+		uint32_t packet = m_FreeHead;
+		if (packet != c_NoPacket)
+			m_FreeHead = m_Packets[packet].Next;
+		else
+		{
+			if (m_Packets.size() == c_NoPacket)
+				throw std::runtime_error("Packet pool is full!");
+
+			packet = (uint32_t)m_Packets.size();
+			m_Packets.emplace_back();
+		}
+
+		m_Packets[packet] = { (uint32_t)initialSNID, c_NoPacket, initialTimestamp, 0 };
+
+		if (list.Empty())
+			list.Head = packet;
+		else
+			m_Packets[list.Tail].Next = packet;
+		list.Tail = packet;
+		list.Count++;
+
+		return packet;
+	}
+
+	void PacketPool::Splice(PacketList& to, PacketList& from)
+	{
+		if (from.Empty())
+			return;
+
+		if (to.Empty())
+			to.Head = from.Head;
+		else
+			m_Packets[to.Tail].Next = from.Head;
+		to.Tail = from.Tail;
+		to.Count += from.Count;
+
+		from = PacketList();
+	}
+
+	void PacketPool::Clear(PacketList& list)
+	{
+		if (list.Empty())
+			return;
+
+		m_Packets[list.Tail].Next = m_FreeHead;
+		m_FreeHead = list.Head;
+
+		list = PacketList();
+	}
+}
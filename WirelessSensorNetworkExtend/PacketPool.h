@@ -0,0 +1,66 @@
+#pragma once
+
+namespace WSN
+{
+	static constexpr uint32_t c_NoPacket = ~(uint32_t)0;
+
+	/// <summary>
+	/// Packet record living in a PacketPool, linked to the next packet of the same list
+	/// </summary>
+	struct Packet
+	{
+		uint32_t InitialSNID;
+		uint32_t Next;
+		double InitialTimestamp;
+		double Size;
+	};
+
+	/// <summary>
+	/// Singly linked segment of packets in a PacketPool, in the order they were added
+	/// </summary>
+	struct PacketList
+	{
+		uint32_t Head = c_NoPacket;
+		uint32_t Tail = c_NoPacket;
+		uint64_t Count = 0;
+
+		inline bool Empty() const { return Head == c_NoPacket; }
+	};
+
+	/// <summary>
+	/// Arena of the packets of every sensor node of a simulation. Packets are never copied : forwarding a list to the parent
+	/// is an O(1) splice and freeing a list hands it as a whole to the free list.
+	/// </summary>
+	class PacketPool
+	{
+	public:
+		inline Packet& operator[](uint32_t packet) { return m_Packets[packet]; }
+		inline const Packet& operator[](uint32_t packet) const { return m_Packets[packet]; }
+
+		/// <summary>
+		/// Appends a new empty packet to list, returns its index
+		/// </summary>
+		uint32_t PushBack(PacketList& list, uint64_t initialSNID, double initialTimestamp);
+
+		/// <summary>
+		/// Moves all packets of from to the end of to, from is left empty
+		/// </summary>
+		void Splice(PacketList& to, PacketList& from);
+
+		/// <summary>
+		/// Frees all packets of list
+		/// </summary>
+		void Clear(PacketList& list);
+
+		template<typename Function>
+		void ForEach(const PacketList& list, Function function) const
+		{
+			for (uint32_t packet = list.Head; packet != c_NoPacket; packet = m_Packets[packet].Next)
+				function(m_Packets[packet]);
+		}
+
+	private:
+		std::vector<Packet> m_Packets;
+		uint32_t m_FreeHead = c_NoPacket;
+	};
+}
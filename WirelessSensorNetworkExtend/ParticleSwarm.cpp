@@ -0,0 +1,89 @@
+#include "PCH.h"
+#include "ParticleSwarm.h"
+
+namespace WSN
+{
+	ParticleSwarm::ParticleSwarm(size_t dimensionCount, std::vector<Philox> randoms, const ParticleSwarmParameters& parameters)
+		: m_DimensionCount(dimensionCount), m_ParticleCount(randoms.size()), m_Parameters(parameters), m_Randoms(std::move(randoms)),
+		m_Positions(m_ParticleCount * dimensionCount), m_Velocities(m_ParticleCount * dimensionCount), m_BestPositions(m_ParticleCount * dimensionCount),
+		m_BestValues(m_ParticleCount), m_SwarmBestPosition(dimensionCount)
+	{
+		if (m_ParticleCount == 0)
+			throw std::runtime_error("A particle swarm needs at least one particle!");
+		if (m_Parameters.BatchSize == 0)
+			throw std::runtime_error("The batch size of a particle swarm can not be 0!");
+	}
+
+	void ParticleSwarm::Initialize()
+	{
+		std::uniform_real_distribution<double> initial(m_Parameters.InitialLow, m_Parameters.InitialHigh);
+
+		for (size_t particle = 0; particle < m_ParticleCount; particle++)
+		{
+			Philox& random = m_Randoms[particle];
+			std::span<double> position = GetRow(m_Positions, particle);
+			std::span<double> velocity = GetRow(m_Velocities, particle);
+
+			for (double& coordinate : position)
+				coordinate = initial(random);
+			for (double& coordinate : velocity)
+			{
+				coordinate = initial(random);
+				if (random() % 2)
+					coordinate *= -1;
+			}
+		}
+
+		m_BestPositions = m_Positions;
+		m_SwarmBestValue = -std::numeric_limits<double>::infinity();
+	}
+
+	void ParticleSwarm::Move(size_t particle)
+	{
+		Philox& random = m_Randoms[particle];
+		std::span<double> position = GetRow(m_Positions, particle);
+		std::span<double> velocity = GetRow(m_Velocities, particle);
+		std::span<double> bestPosition = GetRow(m_BestPositions, particle);
+
+		for (size_t dimension = 0; dimension < m_DimensionCount; dimension++)
+		{
+			velocity[dimension] =
+				m_Parameters.InertiaWeight * velocity[dimension] +
+				m_Parameters.CognitiveCoefficient * Uniform01(random) * (bestPosition[dimension] - position[dimension]) +
+				m_Parameters.SocialCoefficient * Uniform01(random) * (m_SwarmBestPosition[dimension] - position[dimension]);
+		}
+
+		for (size_t dimension = 0; dimension < m_DimensionCount; dimension++)
+			position[dimension] = std::max(position[dimension] + velocity[dimension], 0.0);
+	}
+
+	void ParticleSwarm::Accept(size_t particle, double value)
+	{
+		if (value > m_BestValues[particle])
+		{
+			std::span<double> position = GetRow(m_Positions, particle);
+			std::copy(position.begin(), position.end(), GetRow(m_BestPositions, particle).begin());
+			m_BestValues[particle] = value;
+		}
+	}
+
+	bool ParticleSwarm::UpdateSwarmBest()
+	{
+		size_t bestParticle = m_ParticleCount;
+		for (size_t particle = 0; particle < m_ParticleCount; particle++)
+		{
+			if (m_BestValues[particle] > m_SwarmBestValue)
+			{
+				bestParticle = particle;
+				m_SwarmBestValue = m_BestValues[particle];
+			}
+		}
+
+		if (bestParticle == m_ParticleCount)
+			return false;
+
+		std::span<double> bestPosition = GetRow(m_BestPositions, bestParticle);
+		std::copy(bestPosition.begin(), bestPosition.end(), m_SwarmBestPosition.begin());
+		return true;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "Philox.h"
+
+namespace WSN
+{
+	struct ParticleSwarmParameters
+	{
+		double InertiaWeight = 0.5;
+		double CognitiveCoefficient = 1.5;
+		double SocialCoefficient = 1.5;
+		// stops once the swarm best has not improved for that many iterations
+		int SwarmBestChangeFinishThreshold = 200;
+		// particles moved and evaluated together before the swarm best is updated. Updating it after the whole swarm (fully synchronous PSO)
+		// stalls far from the optimum of the PW, batches of a few particles keep the quality of updating it after every particle
+		size_t BatchSize = 8;
+
+		// initial positions are uniform in [InitialLow, InitialHigh), initial velocities the same with a random sign
+		double InitialLow = 1.0;
+		double InitialHigh = 100000.0;
+	};
+
+	/// <summary>
+	/// Maximizing particle swarm over [0, inf)^dimensionCount. Positions, velocities and bests live in flat arrays allocated once,
+	/// each particle draws from its own Philox stream. The particles are evaluated in batches of BatchSize, all at once by the objective
+	/// (e.g. a lane per particle), and the swarm best is updated after every batch in particle order.
+	/// </summary>
+	class ParticleSwarm
+	{
+	public:
+		/// <param name="randoms">Stream of every particle, their count is the particle count</param>
+		ParticleSwarm(size_t dimensionCount, std::vector<Philox> randoms, const ParticleSwarmParameters& parameters = {});
+
+		/// <summary>
+		/// Runs the swarm until it stalls. batchObjective(std::span&lt;const double* const&gt; positions, std::span&lt;double&gt; values)
+		/// writes the value to maximize of at most BatchSize positions at a time.
+		/// </summary>
+		template<typename BatchObjective>
+		void Optimize(BatchObjective batchObjective);
+
+		inline std::span<const double> GetBestPosition() const { return m_SwarmBestPosition; }
+		inline double GetBestValue() const { return m_SwarmBestValue; }
+		inline int GetIterationCount() const { return m_IterationCount; }
+
+	private:
+		inline std::span<double> GetRow(std::vector<double>& values, size_t particle) { return { values.data() + particle * m_DimensionCount, m_DimensionCount }; }
+
+		// (k + 0.5) / 2^53
+		static inline double Uniform01(Philox& random) { return ((random() >> 11) + 0.5) * 0x1.0p-53; }
+
+		void Initialize();
+
+		/// <summary>
+		/// Moves particle by its velocity
+		/// </summary>
+		void Move(size_t particle);
+
+		/// <summary>
+		/// Updates the best of particle with the value of its current position
+		/// </summary>
+		void Accept(size_t particle, double value);
+
+		/// <summary>
+		/// Takes the best of the particle bests as the swarm best, returns whether it improved
+		/// </summary>
+		bool UpdateSwarmBest();
+
+		size_t m_DimensionCount;
+		size_t m_ParticleCount;
+		ParticleSwarmParameters m_Parameters;
+
+		std::vector<Philox> m_Randoms;
+
+		// particle p is [p * m_DimensionCount, (p + 1) * m_DimensionCount) of every array
+		std::vector<double> m_Positions;
+		std::vector<double> m_Velocities;
+		std::vector<double> m_BestPositions;
+		std::vector<double> m_BestValues;
+
+		std::vector<double> m_SwarmBestPosition;
+		double m_SwarmBestValue = -std::numeric_limits<double>::infinity();
+		int m_IterationCount = 0;
+	};
+
+	template<typename BatchObjective>
+	void ParticleSwarm::Optimize(BatchObjective batchObjective)
+	{
+		Initialize();
+
+		std::vector<const double*> positions(m_Parameters.BatchSize);
+		std::vector<double> values(m_Parameters.BatchSize);
+
+		for (size_t first = 0; first < m_ParticleCount; first += m_Parameters.BatchSize)
+		{
+			size_t count = std::min(m_Parameters.BatchSize, m_ParticleCount - first);
+			for (size_t i = 0; i < count; i++)
+				positions[i] = m_BestPositions.data() + (first + i) * m_DimensionCount;
+
+			batchObjective(std::span<const double* const>(positions.data(), count), std::span<double>(values.data(), count));
+			std::copy(values.begin(), values.begin() + count, m_BestValues.begin() + first);
+		}
+		UpdateSwarmBest();
+
+		int iterationsSinceLastSwarmBestChange = 0;
+		m_IterationCount = 0;
+		while (iterationsSinceLastSwarmBestChange < m_Parameters.SwarmBestChangeFinishThreshold)
+		{
+			bool improved = false;
+			for (size_t first = 0; first < m_ParticleCount; first += m_Parameters.BatchSize)
+			{
+				size_t count = std::min(m_Parameters.BatchSize, m_ParticleCount - first);
+				for (size_t i = 0; i < count; i++)
+				{
+					Move(first + i);
+					positions[i] = m_Positions.data() + (first + i) * m_DimensionCount;
+				}
+
+				batchObjective(std::span<const double* const>(positions.data(), count), std::span<double>(values.data(), count));
+				for (size_t i = 0; i < count; i++)
+					Accept(first + i, values[i]);
+
+				improved |= UpdateSwarmBest();
+			}
+
+			if (improved)
+				iterationsSinceLastSwarmBestChange = 0;
+			else
+				iterationsSinceLastSwarmBestChange++;
+			m_IterationCount++;
+		}
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+namespace WSN
+{
+	// splitmix64 finalizer, neighbouring inputs end up with unrelated outputs
+	inline uint64_t MixBits(uint64_t z)
+	{
+		z += 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	/// <summary>
+	/// Philox4x32-10 (Salmon et al., Random123), a counter based generator : output n of a stream is a pure function
+	/// of (seed, stream, n), so streams need no shared state and can be created, copied or sought anywhere.
+	/// The master seed is the key, the 128 bit counter is the stream id (high half) and the block index (low half).
+	/// Meets UniformRandomBitGenerator, std distributions take it as they are.
+	/// </summary>
+	class Philox
+	{
+	public:
+		using result_type = uint64_t;
+
+		Philox(uint64_t seed = 0, uint64_t stream = 0)
+			: m_Key{ (uint32_t)seed, (uint32_t)(seed >> 32) }, m_Stream(stream)
+		{
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return ~0ull; }
+
+		inline result_type operator()()
+		{
+			if (m_Index == 2)
+				Generate();
+
+			return m_Block[m_Index++];
+		}
+
+		/// <summary>
+		/// Moves to output position of the stream, in O(1)
+		/// </summary>
+		inline void Seek(uint64_t position)
+		{
+			m_Counter = position / 2;
+			m_Index = 2;
+			if (position % 2)
+			{
+				Generate();
+				m_Index = 1;
+			}
+		}
+
+	private:
+		inline void Generate()
+		{
+			static constexpr uint32_t multiplier0 = 0xD2511F53, multiplier1 = 0xCD9E8D57;
+			static constexpr uint32_t weyl0 = 0x9E3779B9, weyl1 = 0xBB67AE85;
+
+			uint32_t c0 = (uint32_t)m_Counter, c1 = (uint32_t)(m_Counter >> 32);
+			uint32_t c2 = (uint32_t)m_Stream, c3 = (uint32_t)(m_Stream >> 32);
+			uint32_t k0 = m_Key[0], k1 = m_Key[1];
+
+			for (int round = 0; round < 10; round++)
+			{
+				uint64_t product0 = (uint64_t)multiplier0 * c0;
+				uint64_t product1 = (uint64_t)multiplier1 * c2;
+
+				uint32_t n0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+				uint32_t n1 = (uint32_t)product1;
+				uint32_t n2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+				uint32_t n3 = (uint32_t)product0;
+				c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+
+				k0 += weyl0;
+				k1 += weyl1;
+			}
+
+			m_Block[0] = c0 | (uint64_t)c1 << 32;
+			m_Block[1] = c2 | (uint64_t)c3 << 32;
+			m_Counter++;
+			m_Index = 0;
+		}
+
+		uint32_t m_Key[2];
+		uint64_t m_Stream;
+		uint64_t m_Counter = 0;
+		uint64_t m_Block[2] = {};
+		int m_Index = 2;
+	};
+
+	enum class RandomPurpose : uint64_t
+	{
+		Placement = 1,
+		PSO,
+		Failures
+	};
+
+	/// <summary>
+	/// Identifies a Philox stream : the sweep point, the redo,
+	/// the node (sensor node, or particle for PSO) and what the numbers are drawn for
+	/// </summary>
+	struct StreamKey
+	{
+		uint64_t Point = 0;
+		uint64_t Redo = 0;
+		uint64_t Node = 0;
+		RandomPurpose Purpose = RandomPurpose::Failures;
+	};
+
+	inline uint64_t GetSubstream(const StreamKey& key)
+	{
+		return MixBits(MixBits(MixBits(MixBits(key.Point) ^ key.Redo) ^ key.Node) ^ (uint64_t)key.Purpose);
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Philox.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Standard exponential (rate 1), 256 layer ziggurat (Marsaglia and Tsang)
+	/// </summary>
+	double SampleExponential(Philox& random);
+
+	/// <summary>
+	/// Standard normal, 256 layer ziggurat (Marsaglia and Tsang)
+	/// </summary>
+	double SampleNormal(Philox& random);
+
+	/// <summary>
+	/// Gamma with scale 1 (Marsaglia and Tsang), shapes below 1 are boosted by U^(1 / shape)
+	/// </summary>
+	double SampleGamma(Philox& random, double shape);
+
+	// Batch samplers filling values, with the parameters of their std counterparts.
+	// Weibull goes through its inverse CDF and lognormal through the normal ziggurat, each transformed in a separate, vectorizable loop.
+
+	void SampleExponential(Philox& random, double rate, std::span<double> values);
+	void SampleNormal(Philox& random, double mean, double stddev, std::span<double> values);
+	void SampleLognormal(Philox& random, double m, double s, std::span<double> values);
+	void SampleGamma(Philox& random, double shape, double scale, std::span<double> values);
+	void SampleWeibull(Philox& random, double shape, double scale, std::span<double> values);
+}
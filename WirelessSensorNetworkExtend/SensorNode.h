@@ -1,4 +1,5 @@
 #pragma once
+#include "PacketPool.h"
 
 namespace WSN
 {
@@ -18,13 +19,6 @@ namespace WSN
 
 	std::string WorkingStateToString(const WorkingState& ws);
 
-	struct Packet
-	{
-		uint64_t InitialSNID;
-		double InitialTimestamp;
-		double Size;
-	};
-
 	class SensorNode
 	{
 	public:
@@ -48,8 +42,9 @@ namespace WSN
 
 		double m_TotalDataSent = 0;
 
-		std::vector<Packet> m_Packets;
+		PacketList m_Packets;
 
-		int m_CurrentPacketIterator = -1;
+		// the packet the sensor node is collecting into, in the PacketPool of its simulation
+		uint32_t m_CurrentPacket = c_NoPacket;
 	};
 }
\ No newline at end of file
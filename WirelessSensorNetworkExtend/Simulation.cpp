@@ -1,6 +1,8 @@
 #include "PCH.h"
 #include "Simulation.h"
 #include "Database.h"
+#include "SpatialGrid.h"
+#include "InterferenceGraph.h"
 
 
 namespace WSN
@@ -50,20 +52,26 @@ namespace WSN
 
 			for (int SNCount = 0; SNCount < m_SimulationParameters.LevelSNCount[i]; )
 			{
-				double xPos = dist.GenerateRandomNumber() * (s_RNG() % 2 ? -1 : 1);
-				double yPos = dist.GenerateRandomNumber() * (s_RNG() % 2 ? -1 : 1);
-
-				if (xPos * xPos + yPos * yPos <= m_SimulationParameters.LevelRadius[i] * m_SimulationParameters.LevelRadius[i]
-					&& (i == 0 || xPos * xPos + yPos * yPos > m_SimulationParameters.LevelRadius[i - 1] * m_SimulationParameters.LevelRadius[i - 1]))
+				// every node is placed from its own stream, retries included
+				Philox random = GetRandom(m_SensorNodes.size(), RandomPurpose::Placement);
+				while (true)
 				{
-					m_SensorNodes.push_back(
-						{
-							{xPos, yPos},
-							(int64_t) -2,
-							(uint64_t)i
-						}
-					);
-					SNCount++;
+					double xPos = dist.GenerateRandomNumber(random) * (random() % 2 ? -1 : 1);
+					double yPos = dist.GenerateRandomNumber(random) * (random() % 2 ? -1 : 1);
+
+					if (xPos * xPos + yPos * yPos <= m_SimulationParameters.LevelRadius[i] * m_SimulationParameters.LevelRadius[i]
+						&& (i == 0 || xPos * xPos + yPos * yPos > m_SimulationParameters.LevelRadius[i - 1] * m_SimulationParameters.LevelRadius[i - 1]))
+					{
+						m_SensorNodes.push_back(
+							{
+								{xPos, yPos},
+								(int64_t) -2,
+								(uint64_t)i
+							}
+						);
+						SNCount++;
+						break;
+					}
 				}
 			}
 		}
@@ -86,366 +94,160 @@ namespace WSN
 
 		using namespace std;
 
-		const short spare = 5;
-
 		class Node {
 		public:
-			float x, y;
-			short tier, index, color = -1, degree = 0;
-			vector <Node> route;
-			Node(float arg1, float arg2, short arg3, short arg4) {
-				x = arg1;
-				y = arg2;
-				tier = arg3;
-				index = arg4;
+			uint64_t index;
+			short tier;
+			int64_t parent = -2;
+			Node(uint64_t arg1, short arg2) {
+				index = arg1;
+				tier = arg2;
 			}
 		};
 
 		vector <Node> node;
-		vector < pair <short, short> > edge;
-
-		auto getDistance = [](Node node1, Node node2)
-		{
-			return sqrt((node1.x - node2.x) * (node1.x - node2.x) + (node1.y - node2.y) * (node1.y - node2.y));
-		};
 
+		// the parent is the closest node of the tier below, if it is within transmission range
 		auto findParent = [&]() {
+			vector <vector <uint64_t>> tierSNIDs;
 			for (auto& i : node) {
-				if (i.tier) {
-					vector < pair <Node, float> > pos;
-					for (auto j : node) {
-						if (i.tier == j.tier + 1)
-							pos.push_back(make_pair(j, getDistance(i, j)));
-					}
-					sort(pos.begin(), pos.end(), [&](pair <Node, float> ll, pair <Node, float> rr) {
-						return ll.second < rr.second;
-						});
-					for (short j = 0; j < spare; ++j)
-						if (pos[j].second <= m_SimulationParameters.TransmissionRange)
-							i.route.push_back(pos[j].first);
-				}
+				if (i.tier >= tierSNIDs.size())
+					tierSNIDs.resize(i.tier + 1);
+				tierSNIDs[i.tier].push_back(i.index);
 			}
-		};
 
-		auto findColor = [&]() {
-			for (auto& i : node)
-				for (auto j : node)
-					if (getDistance(i, j) <= m_SimulationParameters.InterferenceRange)
-						++i.degree;
-			sort(node.begin(), node.end(), [&](Node node1, Node node2) {
-				return node1.degree > node2.degree;
-				});
-			bool exist = 1;
-			for (short i = 0; exist; ++i) {
-				exist = 0;
-				for (auto& j : node) {
-					if (j.color != -1)
-						continue;
-					bool con = 0;
-					for (auto& k : node)
-						if (k.color == i && getDistance(j, k) <= m_SimulationParameters.InterferenceRange) {
-							con = 1;
-							break;
-						}
-					if (!con) {
-						j.color = i;
-						exist = 1;
-					}
+			vector <SpatialGrid> tierGrids;
+			for (auto& i : tierSNIDs)
+				tierGrids.emplace_back(m_SensorNodes, i);
+
+			vector <uint64_t> closest;
+			for (auto& i : node) {
+				if (i.tier) {
+					tierGrids[i.tier - 1].KNearest(m_SensorNodes[i.index].m_Position, 1, m_SimulationParameters.TransmissionRange, closest);
+					if (!closest.empty())
+						i.parent = closest[0];
 				}
 			}
 		};
 
-
-		for (short i = 0, l; i < m_SensorNodes.size(); ++i) {
-			float j, k;
-			node.push_back(Node(m_SensorNodes[i].m_Position.X, m_SensorNodes[i].m_Position.Y, m_SensorNodes[i].m_Level, i));
-		}
+		for (uint64_t i = 0; i < m_SensorNodes.size(); ++i)
+			node.push_back(Node(i, m_SensorNodes[i].m_Level));
 
 		findParent();
-		findColor();
 
-		//for (auto i : node) {
-		//	cout << i.index << ":";
-		//	for (auto j : i.route)
-		//		cout << ' ' << j.index;
-		//	cout << endl;
-		//}
+		// fewer colors also means a shorter TDMA superframe
+		InterferenceGraph interferenceGraph(m_SensorNodes, m_SimulationParameters.InterferenceRange);
+		std::vector<uint64_t> colors = interferenceGraph.ColorDSATUR();
 
 		for (int i = 0; i < node.size(); i++)
 		{
 			if (node[i].tier == 0)
 				m_SensorNodes[node[i].index].m_Parent = -1;
 			else
-			{
-				if(node[i].route.size() > 0)
-					m_SensorNodes[node[i].index].m_Parent = node[i].route[0].index;
-			}
-			m_SensorNodes[node[i].index].m_Color = node[i].color;
+				m_SensorNodes[node[i].index].m_Parent = node[i].parent;
+			m_SensorNodes[node[i].index].m_Color = colors[node[i].index];
 		}
 #endif
 
 
 	}
 	 
-	// big parameters, i.e. durations instead of rates
-	double PWSteadyStateFunc(double selfDelta, double selfTau, double selfLambda, double selfReparationTime, std::vector<double> childrenPWs)
-	{
-		double mu = 1.0;
-		for (int i = 0; i < childrenPWs.size(); i++)
-			mu += childrenPWs[i];
-		mu *= selfReparationTime + selfDelta / 2.0;
-
-		return 1.0 / (1.0 + (selfTau / selfDelta) + (mu / selfLambda));
-	}
-
-
 	void Simulation::CalculateSNDeltaOpts()
 	{
-		static constexpr int particleCount = 50;
-		static constexpr double inertiaWeight = 0.5;
-		static constexpr double cognitiveCoefficient = 1.5;
-		static constexpr double socialCoefficient = 1.5;
-		static constexpr int swarmBestChangeFinishThreshold = 200;
+		PWTree tree(m_SensorNodes, m_SimulationParameters.LevelRadius.size(), m_SimulationParameters.TransferTime,
+			m_SimulationParameters.FailureDistribution.m_Mean, m_SimulationParameters.RecoveryTime);
 
+		std::vector<DeltaOptimizerType> optimizerTypes = { m_SimulationParameters.DeltaOptimizer };
+		if (m_SimulationParameters.CompareDeltaOptimizers)
+			for (DeltaOptimizerType type : { DeltaOptimizerType::ParticleSwarm, DeltaOptimizerType::Tree })
+				if (type != m_SimulationParameters.DeltaOptimizer)
+					optimizerTypes.push_back(type);
 
-		std::vector<std::vector<uint64_t>> children(m_SensorNodes.size());
-
-		std::vector<std::vector<double>> particles;
-
-		std::vector<std::vector<double>> particlesVelocity;
-
-		std::vector<std::vector<double>> particlesBestCoords;
-
-		std::vector<double> particlesBestValue;
-
-		std::vector<double> swarmBestCoords;
-		double swarmBestValue;
-
-		for (int i = 0; i < m_SensorNodes.size(); i++)
+		DeltaOptimization optimization;
+		for (DeltaOptimizerType type : optimizerTypes)
 		{
-			if (m_SensorNodes[i].m_Parent == -1)
-				continue;
+			auto startTime = std::chrono::steady_clock::now();
+			DeltaOptimization current = CreateDeltaOptimizer(type)->Optimize(tree);
+			std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
 
-			if (m_SensorNodes[i].m_Parent == -2)
-				throw std::runtime_error("An SN does not have any parents !");
+			if (m_SimulationParameters.CompareDeltaOptimizers)
+				std::cout << "PW (" << DeltaOptimizerTypeToString(type) << ") = " << current.BSTotal / m_SensorNodes.size() << " in " << duration.count() << " s\n";
 
-			children[m_SensorNodes[i].m_Parent].push_back(i);
+			if (type == m_SimulationParameters.DeltaOptimizer)
+				optimization = std::move(current);
 		}
 
-		auto CalculatePW = [&](std::vector<double> deltasIn)
-		{
-			std::vector<double> CWs(m_SensorNodes.size());
-
-			for (int i = m_SimulationParameters.LevelRadius.size() - 1; i >= 0; i--)
-			{
-				for (int j = 0; j < m_SensorNodes.size(); j++)
-				{
-					if (m_SensorNodes[j].m_Level != i)
-						continue;
-
-					std::vector<double> childrenCWs;
-					for (int k = 0; k < children[j].size(); k++)
-						//childrenPWs.push_back(PWs[children[j][k]]);
-						childrenCWs.push_back(CWs[children[j][k]]);
-
-					CWs[j] = PWSteadyStateFunc(deltasIn[j], m_SimulationParameters.TransferTime,
-						m_SimulationParameters.FailureDistribution.m_Mean, m_SimulationParameters.RecoveryTime, childrenCWs);
-
-					for (int k = 0; k < children[j].size(); k++)
-						CWs[j] += CWs[children[j][k]];
-				}
-			}
-
-			double BSTotal = 0.0;
-			for (int i = 0; i < CWs.size(); i++)
-			{
-				if (m_SensorNodes[i].m_Parent == -1)
-					//BSTotal += PWs[i];
-					BSTotal += CWs[i];
-			}
-
-			return BSTotal;
-		};
-
-		static constexpr double randomRangeHigh = 100000.0;
-		static constexpr double randomRangeLow = 1.0;
-
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+			m_SensorNodes[i].m_DeltaOpt = optimization.Deltas[i];
+		m_SimulationResults.CWSNEfficiency = optimization.BSTotal / m_SensorNodes.size();
 
-		// mean = (A + B) / 2
-		// stddev = sqrt((b-a) * (b-a) / 12)
-		Distribution dist(DistributionType::Uniform, (randomRangeHigh + randomRangeLow) / 2.0,
-			std::sqrt((randomRangeHigh - randomRangeLow) * (randomRangeHigh - randomRangeLow) / 12.0));
+		std::cout << "Delta = ( ";
+		for (int i = 0; i < optimization.Deltas.size(); i++)
+			std::cout << optimization.Deltas[i] << ", ";
+		std::cout << " )\nPW = " << optimization.BSTotal / m_SensorNodes.size() << "\n--------------------------------------------------------------------------------------\n";
 
-		Distribution dist01(DistributionType::Uniform, 1 / 2.0,
-			std::sqrt(1 / 12.0));
+		std::cout << "Done!\n";
+	}
 
+	std::unique_ptr<DeltaOptimizer> Simulation::CreateDeltaOptimizer(DeltaOptimizerType type) const
+	{
+		static constexpr int particleCount = 50;
 
-		// particle count
-		for (int i = 0; i < particleCount; i++)
+		switch (type)
 		{
-			std::vector<double> deltas;
-			deltas.reserve(m_SensorNodes.size());
-			for (int j = 0; j < m_SensorNodes.size(); j++)
-				deltas.push_back(dist.GenerateRandomNumber());
-			particles.push_back(deltas);
-			particlesBestCoords.push_back(deltas);
-			particlesBestValue.push_back(CalculatePW(deltas));
-			
-			std::vector<double> velos;
-			velos.reserve(m_SensorNodes.size());
-			for (int j = 0; j < m_SensorNodes.size(); j++)
-			{
-				double velo = dist.GenerateRandomNumber();
-				if (s_RNG() % 2)
-					velo *= -1;
-				velos.push_back(velo);
-			}
-			particlesVelocity.push_back(velos);
-		}
-
-
+		case DeltaOptimizerType::ParticleSwarm:
 		{
-			int bestIndex = -1;
-			double bestValue = -1;
-			for (int i = 0; i < particlesBestCoords.size(); i++)
-			{
-				if (particlesBestValue[i] > bestValue)
-				{
-					bestIndex = i;
-					bestValue = particlesBestValue[i];
-				}
-			}
+			// one stream per particle
+			std::vector<Philox> particleRandoms;
+			for (int i = 0; i < particleCount; i++)
+				particleRandoms.push_back(GetRandom(i, RandomPurpose::PSO));
 
-			swarmBestCoords = particlesBestCoords[bestIndex];
-			swarmBestValue = bestValue;
+			return std::make_unique<ParticleSwarmDeltaOptimizer>(std::move(particleRandoms), m_SimulationParameters.ReduceDeltaSymmetry);
 		}
-
-		int iterationsSinceLastSwarmBestChange = 0;
-		int iteration = 0;
-
-		while (iterationsSinceLastSwarmBestChange < swarmBestChangeFinishThreshold)
-		{
-			auto particlesTemp = particles;
-
-			for (int particle = 0; particle < particleCount; particle++)
-			{
-				for (int dimension = 0; dimension < m_SensorNodes.size(); dimension++)
-				{
-					particlesVelocity[particle][dimension] =
-						inertiaWeight * particlesVelocity[particle][dimension] +
-						cognitiveCoefficient * dist01.GenerateRandomNumber() * (particlesBestCoords[particle][dimension] - particles[particle][dimension]) +
-						socialCoefficient * dist01.GenerateRandomNumber() * (swarmBestCoords[dimension] - particles[particle][dimension]);
-				}
-
-				for (int dimension = 0; dimension < m_SensorNodes.size(); dimension++)
-				{
-					particlesTemp[particle][dimension] += particlesVelocity[particle][dimension];
-					if (particlesTemp[particle][dimension] < 0.0)
-						particlesTemp[particle][dimension] = 0.0;
-					//if (particlesTemp[particle][dimension] > 100000.0)
-					//	particlesTemp[particle][dimension] = 100000.0;
-				}
-
- 				double temp = CalculatePW(particlesTemp[particle]);
-				if (temp > particlesBestValue[particle])
-				{
-					particlesBestCoords[particle] = particlesTemp[particle];
-					particlesBestValue[particle] = temp;
-
-					if (temp > swarmBestValue)
-					{
-						swarmBestCoords = particlesTemp[particle];
-						swarmBestValue = temp;
-						iterationsSinceLastSwarmBestChange = -1;
-					}
-
-				}
-			}
-
-			particles = particlesTemp;
-
-			iterationsSinceLastSwarmBestChange++;
-			iteration++;
-
-			//std::cout << "Iteration : " << iteration << '\n';
-			//std::cout << "Delta = ( ";
-			//for (int i = 0; i < swarmBestCoords.size(); i++)
-			//	std::cout << swarmBestCoords[i] << ", ";
-			//std::cout << " )\nPW = " << swarmBestValue << "\n--------------------------------------------------------------------------------------\n";
+		case DeltaOptimizerType::Tree:
+			return std::make_unique<TreeDeltaOptimizer>();
 		}
 
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-			m_SensorNodes[i].m_DeltaOpt = swarmBestCoords[i];
-		m_SimulationResults.CWSNEfficiency = swarmBestValue / m_SensorNodes.size();
-
-		std::cout << "Delta = ( ";
-		for (int i = 0; i < swarmBestCoords.size(); i++)
-			std::cout << swarmBestCoords[i] << ", ";
-		std::cout << " )\nPW = " << swarmBestValue / m_SensorNodes.size() << "\n--------------------------------------------------------------------------------------\n";
+		throw std::runtime_error("Unknown Delta Optimizer Type in CreateDeltaOptimizer!");
+		return nullptr;
+	}
 
-		std::cout << "Done!\n";
+	Philox Simulation::GetRandom(uint64_t node, RandomPurpose purpose) const
+	{
+		return Philox(m_SimulationParameters.Seed, GetSubstream({ m_SimulationParameters.SweepPoint, m_SimulationParameters.Redo, node, purpose }));
 	}
 
 	void Simulation::Run()
 	{
-		double seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-		InnerRun(SimulationType::FT_TDMA, seed);
+		std::vector<Philox> failureRandoms;
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+			failureRandoms.push_back(GetRandom(i, RandomPurpose::Failures));
+
+		// the failures drawn for the first run are replayed by the second one
+		m_FailureStreams = std::make_unique<FailureStreams>(m_SimulationParameters.FailureDistribution, std::move(failureRandoms));
+
+		InnerRun(SimulationType::FT_TDMA);
 		Reset();
-		InnerRun(SimulationType::RR_TDMA, seed);
+		InnerRun(SimulationType::RR_TDMA);
 	}
 
-	void Simulation::InnerRun(SimulationType simulationType, double seed)
+	void Simulation::InnerRun(SimulationType simulationType)
 	{
-		std::mt19937_64 innerRNG(seed);
-
-		static constexpr double failGenerationDurationMultiplier = 0.1;
-
 		SimulationResults& sr = m_SimulationResults;
 			
-		struct WorkingStateTimestamp
-		{
-			uint64_t SNID;
-			WorkingState State;
-			double Timestamp;
-		};
-
 		std::vector<WorkingStateTimestamp> previousEvents;
-		auto pqCompare = [](WorkingStateTimestamp left, WorkingStateTimestamp right) 
-		{ 
-			if (left.Timestamp > right.Timestamp)
-				return true;
-			else if (left.Timestamp < right.Timestamp)
-				return false;
-
-			return left.SNID < right.SNID;
-		};
 
-		std::priority_queue<WorkingStateTimestamp, std::vector<WorkingStateTimestamp>, decltype(pqCompare)> eventQueue(pqCompare);
+		// every node always has exactly one pending event, rescheduled in place once handled
+		// transfers start on slot boundaries, which the timing wheel buckets by
+		EventScheduler eventQueue(m_SimulationParameters.EventScheduler, m_SensorNodes.size(), m_SimulationParameters.TransferTime);
 		for (int i = 0; i < m_SensorNodes.size(); i++)
 		{
-			eventQueue.push({ (uint64_t)i, WorkingState::Collection, 0.0 });
+			eventQueue.Update({ (uint64_t)i, WorkingState::Collection, 0.0 });
 			previousEvents.push_back({ (uint64_t)i, WorkingState::Collection, 0.0 });
 		}
 		
-		// Generating failure timestamps
-		std::vector<std::vector<double>> SNsFailureTimestamps(m_SensorNodes.size());
-		std::vector<int> SNsFailureTimestampsIterator(m_SensorNodes.size(), 0);
-#if 1
-		for(int i = 0; i < m_SensorNodes.size(); i++)
-		{
-			double currentTime = 0;
-			double timeToNextFailure;
-			while (currentTime < failGenerationDurationMultiplier * m_SimulationParameters.TotalDurationToBeTransferred)
-			{
-				timeToNextFailure = m_SimulationParameters.FailureDistribution.GenerateRandomNumber(innerRNG);
-				currentTime += timeToNextFailure;
-				// LOOK AT THIS
-				sr.Failures.push_back({ (uint64_t)i, currentTime });
-				SNsFailureTimestamps[i].push_back(currentTime);
-				//eventQueue.push({ SNID, WorkingState::Recovery, currentTime });
-			}
-		}
-#endif
+		// failures are drawn on demand from m_FailureStreams, this is the next one of every node
+		std::vector<size_t> SNsFailureTimestampsIterator(m_SensorNodes.size(), 0);
 
 		int colorCount = -1;
 		for (int i = 0; i < m_SensorNodes.size(); i++)
@@ -453,7 +255,12 @@ namespace WSN
 		colorCount++;
 		std::cout << "colorCount = " << colorCount << '\n';
 
-		double transferredTotalDuration = 0;
+		SimulationProgress progress;
+		progress.StartTime = std::chrono::steady_clock::now();
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+			if (m_SensorNodes[i].m_TotalDataSent <= m_SimulationParameters.TotalDurationToBeTransferred)
+				progress.PendingSNCount++;
+
 		double currentTime = 0.0;
 		int failureCount = 0;
 
@@ -463,11 +270,10 @@ namespace WSN
 
 		while (condition)
 		{
-			auto currentEvent = eventQueue.top();
+			auto currentEvent = eventQueue.Top();
 			currentTime = currentEvent.Timestamp;
 			auto& currentState = currentEvent.State;
 			auto& currentSN = currentEvent.SNID;
-			eventQueue.pop();
 
 			superSlotIterator = currentTime / (m_SimulationParameters.TransferTime * colorCount);
 
@@ -572,15 +378,17 @@ namespace WSN
 					nextState = WorkingState::Collection;
 				}
 
-				if (SNsFailureTimestampsIterator[currentSN] < SNsFailureTimestamps[currentSN].size() && 
-					nextTime >= SNsFailureTimestamps[currentSN][SNsFailureTimestampsIterator[currentSN]])
+				double nextFailureTimestamp = m_FailureStreams->Get(currentSN, SNsFailureTimestampsIterator[currentSN]);
+				if (nextTime >= nextFailureTimestamp)
 				{
-					eventQueue.push({ currentSN, WorkingState::Recovery, SNsFailureTimestamps[currentSN][SNsFailureTimestampsIterator[currentSN]] });
+					eventQueue.Update({ currentSN, WorkingState::Recovery, nextFailureTimestamp });
 					SNsFailureTimestampsIterator[currentSN]++;
+					if (m_SimulationParameters.RecordFailures)
+						sr.Failures.push_back({ currentSN, nextFailureTimestamp });
 				}
 				else
 				{
-					eventQueue.push({ currentSN, nextState, nextTime });
+					eventQueue.Update({ currentSN, nextState, nextTime });
 				}
 			}
 
@@ -589,24 +397,23 @@ namespace WSN
 			{
 				if (currentState == WorkingState::Collection) // handles the initialization
 				{
-					m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
+					m_SensorNodes[currentSN].m_CurrentPacket = m_PacketPool.PushBack(m_SensorNodes[currentSN].m_Packets, currentSN, currentTime);
 				}
 				else if (currentState == WorkingState::Transfer)
 				{
 					m_SensorNodes[currentSN].m_CollectionTime += currentTime - previousEvents[currentSN].Timestamp;
 					m_SensorNodes[currentSN].m_CurrentData += currentTime - previousEvents[currentSN].Timestamp;
 					m_SensorNodes[currentSN].m_EnergyConsumed += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulationParameters.EnergyRateWorking + s_EnergyTransitionWorkingToTransfer;
-					//m_SensorNodes[currentSN].m_Packets[m_SensorNodes[currentSN].m_CurrentPacketIterator].Size += currentTime - previousEvents[currentSN].Timestamp; // look at this
-					m_SensorNodes[currentSN].m_Packets[m_SensorNodes[currentSN].m_CurrentPacketIterator].Size += currentTime - m_SensorNodes[currentSN].m_Packets[m_SensorNodes[currentSN].m_CurrentPacketIterator].InitialTimestamp; // look at this
+					//m_PacketPool[m_SensorNodes[currentSN].m_CurrentPacket].Size += currentTime - previousEvents[currentSN].Timestamp; // look at this
+					m_PacketPool[m_SensorNodes[currentSN].m_CurrentPacket].Size += currentTime - m_PacketPool[m_SensorNodes[currentSN].m_CurrentPacket].InitialTimestamp; // look at this
 				}
 				else if (currentState == WorkingState::Recovery)
 				{
 					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
 					failureCount++;
 					m_SensorNodes[currentSN].m_EnergyConsumed += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulationParameters.EnergyRateWorking;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = - 1;
+					m_PacketPool.Clear(m_SensorNodes[currentSN].m_Packets);
+					m_SensorNodes[currentSN].m_CurrentPacket = c_NoPacket;
 				}
 			}
 			else if (previousEvents[currentSN].State == WorkingState::Transfer)
@@ -618,30 +425,33 @@ namespace WSN
 						if (previousEvents[m_SensorNodes[currentSN].m_Parent].State != WorkingState::Recovery)
 						{
 							m_SensorNodes[m_SensorNodes[currentSN].m_Parent].m_CurrentData += m_SensorNodes[currentSN].m_CurrentData;
-							for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
-								m_SensorNodes[m_SensorNodes[currentSN].m_Parent].m_Packets.push_back(m_SensorNodes[currentSN].m_Packets[i]);
+							m_PacketPool.Splice(m_SensorNodes[m_SensorNodes[currentSN].m_Parent].m_Packets, m_SensorNodes[currentSN].m_Packets);
 						}
 					}
 					else
 					{
-						transferredTotalDuration += m_SensorNodes[currentSN].m_CurrentData;
-						for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
+						progress.TransferredTotalDuration += m_SensorNodes[currentSN].m_CurrentData;
+						m_PacketPool.ForEach(m_SensorNodes[currentSN].m_Packets, [&](const Packet& packet)
 						{
-							m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_SentPacketTotalDelay += currentTime - m_SensorNodes[currentSN].m_Packets[i].InitialTimestamp;
-							m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_SentPacketCount++;
-
-							m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_TotalDataSent += m_SensorNodes[currentSN].m_Packets[i].Size;
-						}
+							m_SensorNodes[packet.InitialSNID].m_SentPacketTotalDelay += currentTime - packet.InitialTimestamp;
+							m_SensorNodes[packet.InitialSNID].m_SentPacketCount++;
+
+							// the only place m_TotalDataSent grows, so the pending count is kept here
+							double& totalDataSent = m_SensorNodes[packet.InitialSNID].m_TotalDataSent;
+							bool wasPending = totalDataSent <= m_SimulationParameters.TotalDurationToBeTransferred;
+							totalDataSent += packet.Size;
+							if (wasPending && totalDataSent > m_SimulationParameters.TotalDurationToBeTransferred)
+								progress.PendingSNCount--;
+						});
 
 					}
 
-					m_SensorNodes[currentSN].m_Packets.clear();
+					m_PacketPool.Clear(m_SensorNodes[currentSN].m_Packets);
 
 					m_SensorNodes[currentSN].m_WastedTime += m_SimulationParameters.TransferTime;
 					m_SensorNodes[currentSN].m_CurrentData = 0;
 					m_SensorNodes[currentSN].m_EnergyConsumed += m_SimulationParameters.TransferTime * m_SimulationParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-					m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
+					m_SensorNodes[currentSN].m_CurrentPacket = m_PacketPool.PushBack(m_SensorNodes[currentSN].m_Packets, currentSN, currentTime);
 				}
 				else if (currentState == WorkingState::Transfer) {} // not possible
 				else if (currentState == WorkingState::Recovery) // WARNING : PARTIAL TRANSFER FAILS	
@@ -650,8 +460,8 @@ namespace WSN
 					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
 					failureCount++;
 					m_SensorNodes[currentSN].m_EnergyConsumed += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulationParameters.EnergyRateTransfer;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = - 1;
+					m_PacketPool.Clear(m_SensorNodes[currentSN].m_Packets);
+					m_SensorNodes[currentSN].m_CurrentPacket = c_NoPacket;
 				}
 			}
 			else if (previousEvents[currentSN].State == WorkingState::Recovery)
@@ -659,38 +469,28 @@ namespace WSN
 				if (currentState == WorkingState::Collection)
 				{
 					m_SensorNodes[currentSN].m_WastedTime += m_SimulationParameters.RecoveryTime;
-					m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
+					m_SensorNodes[currentSN].m_CurrentPacket = m_PacketPool.PushBack(m_SensorNodes[currentSN].m_Packets, currentSN, currentTime);
 				}
 				else if (currentState == WorkingState::Transfer) {} // not possible
 				else if (currentState == WorkingState::Recovery)
 				{
 					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
 					failureCount++;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator =  - 1;
+					m_PacketPool.Clear(m_SensorNodes[currentSN].m_Packets);
+					m_SensorNodes[currentSN].m_CurrentPacket = c_NoPacket;
 				}
 			}
 
 			// throw std::runtime_error("Exceeded the last failure point!");;
 			previousEvents[currentSN] = currentEvent;
 			
-			if (m_SensorNodes[currentSN].m_Packets.size() > 1000)
-				std::cout << "m_SensorNodes[currentSN].m_Packets.size() = " << m_SensorNodes[currentSN].m_Packets.size() << '\n';
+			if (m_SensorNodes[currentSN].m_Packets.Count > 1000)
+				std::cout << "m_SensorNodes[currentSN].m_Packets.Count = " << m_SensorNodes[currentSN].m_Packets.Count << '\n';
 
 
-			//condition = transferredTotalDuration < m_SimulationParameters.TotalDurationToBeTransferred;
-
-			condition = false;
-			for (int i = 0; i < m_SensorNodes.size(); i++)
-			{
-				if (m_SensorNodes[i].m_TotalDataSent <= m_SimulationParameters.TotalDurationToBeTransferred)
-				{
-					condition = true;
-					break;
-				}
-			}
-			//condition = currentTime < m_SimulationParameters.TotalDurationToBeTransferred;
+			progress.CurrentTime = currentTime;
+			progress.EventCount++;
+			condition = !m_SimulationParameters.Termination->IsReached(progress);
 		}
 
 		sr.ActualTotalDuration = currentTime;
@@ -721,7 +521,7 @@ namespace WSN
 			m_SensorNodes[i].m_EnergyConsumed = 0;
 			m_SensorNodes[i].m_SentPacketTotalDelay = 0;
 			m_SensorNodes[i].m_SentPacketCount = 0;
-			m_SensorNodes[i].m_Packets.clear();
+			m_PacketPool.Clear(m_SensorNodes[i].m_Packets);
 			m_SensorNodes[i].m_TotalDataSent = 0;
 		}
 
@@ -1,6 +1,10 @@
 #pragma once
 #include "Distribution.h"
 #include "SensorNode.h"
+#include "EventScheduler.h"
+#include "Termination.h"
+#include "FailureStreams.h"
+#include "DeltaOptimizer.h"
 
 namespace WSN
 {
@@ -27,6 +31,7 @@ namespace WSN
 		uint64_t FinalFailureIndex = 0;
 		double CWSNEfficiency = 0;
 
+		// failures the run went through, only kept with SimulationParameters::RecordFailures
 		std::vector<Failure> Failures;
 	};
 
@@ -49,6 +54,24 @@ namespace WSN
 
 		double TransmissionRange;
 		double InterferenceRange;
+
+		// master seed and place of the simulation in the sweep, every Philox stream of the simulation is keyed by them
+		uint64_t Seed = 0;
+		uint64_t SweepPoint = 0;
+		uint64_t Redo = 0;
+
+		EventSchedulerType EventScheduler = EventSchedulerType::Heap;
+
+		// checked after every event, by default until every sensor node has sent TotalDurationToBeTransferred
+		std::shared_ptr<const TerminationCondition> Termination = std::make_shared<AllSNsDelivered>();
+
+		bool RecordFailures = false;
+
+		DeltaOptimizerType DeltaOptimizer = DeltaOptimizerType::ParticleSwarm;
+		// also runs the other optimizers on the same tree and prints their PW and time next to the one of DeltaOptimizer
+		bool CompareDeltaOptimizers = false;
+		// the PSO only searches one delta per class of isomorphic subtrees
+		bool ReduceDeltaSymmetry = false;
 	};
 
 
@@ -78,7 +101,14 @@ namespace WSN
 		inline SimulationParameters GetSimulationParameters() const { return m_SimulationParameters; }
 
 	private:
-		void InnerRun(SimulationType simulationType, double seed);
+		void InnerRun(SimulationType simulationType);
+
+		/// <summary>
+		/// Stream of node (sensor node or particle) for purpose, the same for every run with the same parameters
+		/// </summary>
+		Philox GetRandom(uint64_t node, RandomPurpose purpose) const;
+
+		std::unique_ptr<DeltaOptimizer> CreateDeltaOptimizer(DeltaOptimizerType type) const;
 
 		uint64_t m_SimulationID;
 
@@ -87,6 +117,8 @@ namespace WSN
 		SimulationParameters m_SimulationParameters;
 
 		std::vector<SensorNode> m_SensorNodes;
+		PacketPool m_PacketPool;
+		std::unique_ptr<FailureStreams> m_FailureStreams;
 
 		SimulationResults m_SimulationResults;
 
@@ -0,0 +1,137 @@
+#include "PCH.h"
+#include "SpatialGrid.h"
+
+namespace WSN
+{
+	SpatialGrid::SpatialGrid(const std::vector<SensorNode>& sensorNodes, const std::vector<uint64_t>& SNIDs)
+	{
+		if (SNIDs.empty())
+		{
+			m_CellStarts = { 0, 0 };
+			return;
+		}
+
+		double maxX = sensorNodes[SNIDs[0]].m_Position.X;
+		double maxY = sensorNodes[SNIDs[0]].m_Position.Y;
+		m_MinX = maxX;
+		m_MinY = maxY;
+		for (uint64_t SNID : SNIDs)
+		{
+			m_MinX = std::min(m_MinX, sensorNodes[SNID].m_Position.X);
+			m_MinY = std::min(m_MinY, sensorNodes[SNID].m_Position.Y);
+			maxX = std::max(maxX, sensorNodes[SNID].m_Position.X);
+			maxY = std::max(maxY, sensorNodes[SNID].m_Position.Y);
+		}
+
+		// about 2 nodes per cell, degenerate (collinear or single point) layouts fall back to the longest side
+		const double width = maxX - m_MinX;
+		const double height = maxY - m_MinY;
+		m_CellSize = std::max(std::sqrt(2 * width * height / SNIDs.size()), std::max(width, height) / SNIDs.size());
+		if (!(m_CellSize > 0))
+			m_CellSize = 1;
+
+		m_CellCountX = GetCellX(maxX) + 1;
+		m_CellCountY = GetCellY(maxY) + 1;
+
+		// counting sort of the nodes by cell
+		m_CellStarts.assign(m_CellCountX * m_CellCountY + 1, 0);
+		for (uint64_t SNID : SNIDs)
+			m_CellStarts[GetCellY(sensorNodes[SNID].m_Position.Y) * m_CellCountX + GetCellX(sensorNodes[SNID].m_Position.X) + 1]++;
+		for (size_t cell = 1; cell < m_CellStarts.size(); cell++)
+			m_CellStarts[cell] += m_CellStarts[cell - 1];
+
+		m_Entries.resize(SNIDs.size());
+		std::vector<size_t> cellEnds(m_CellStarts.begin(), m_CellStarts.end() - 1);
+		for (uint64_t SNID : SNIDs)
+		{
+			const Position& position = sensorNodes[SNID].m_Position;
+			m_Entries[cellEnds[GetCellY(position.Y) * m_CellCountX + GetCellX(position.X)]++] = { position.X, position.Y, SNID };
+		}
+	}
+
+	void SpatialGrid::KNearest(const Position& position, size_t k, double maxDistance, std::vector<uint64_t>& SNIDs) const
+	{
+		SNIDs.clear();
+		if (k == 0 || m_Entries.empty())
+			return;
+
+		const double maxSquaredDistance = maxDistance * maxDistance;
+
+		// the k best so far as (squared distance, SNID), sorted
+		std::vector<std::pair<double, uint64_t>> best;
+		best.reserve(k + 1);
+
+		auto visit = [&](const Entry& entry)
+		{
+			std::pair<double, uint64_t> candidate = { (entry.X - position.X) * (entry.X - position.X) + (entry.Y - position.Y) * (entry.Y - position.Y), entry.SNID };
+			if (candidate.first > maxSquaredDistance || (best.size() == k && !(candidate < best.back())))
+				return;
+
+			best.insert(std::upper_bound(best.begin(), best.end(), candidate), candidate);
+			if (best.size() > k)
+				best.pop_back();
+		};
+
+		const int64_t cellX = GetCellX(position.X);
+		const int64_t cellY = GetCellY(position.Y);
+		const int64_t lastRing = std::max(std::max(std::abs(cellX), std::abs(cellX - (m_CellCountX - 1))), std::max(std::abs(cellY), std::abs(cellY - (m_CellCountY - 1))));
+
+		// square rings of cells around the cell of position, a cell of ring r is at least (r - 1) cells away
+		for (int64_t ring = 0; ring <= lastRing; ring++)
+		{
+			if (ring > 1)
+			{
+				double ringSquaredDistance = (ring - 1) * m_CellSize * (ring - 1) * m_CellSize;
+				if (ringSquaredDistance > maxSquaredDistance || (best.size() == k && ringSquaredDistance > best.back().first))
+					break;
+			}
+
+			if (ring == 0)
+			{
+				ForEachInCell(cellX, cellY, visit);
+				continue;
+			}
+
+			const int64_t firstX = std::max(cellX - ring, (int64_t)0);
+			const int64_t lastX = std::min(cellX + ring, m_CellCountX - 1);
+			for (int64_t x = firstX; x <= lastX; x++)
+			{
+				ForEachInCell(x, cellY - ring, visit);
+				ForEachInCell(x, cellY + ring, visit);
+			}
+
+			const int64_t firstY = std::max(cellY - ring + 1, (int64_t)0);
+			const int64_t lastY = std::min(cellY + ring - 1, m_CellCountY - 1);
+			for (int64_t y = firstY; y <= lastY; y++)
+			{
+				ForEachInCell(cellX - ring, y, visit);
+				ForEachInCell(cellX + ring, y, visit);
+			}
+		}
+
+		for (const auto& [squaredDistance, SNID] : best)
+			SNIDs.push_back(SNID);
+	}
+
+	void SpatialGrid::WithinRadius(const Position& position, double radius, std::vector<uint64_t>& SNIDs) const
+	{
+		SNIDs.clear();
+		if (m_Entries.empty())
+			return;
+
+		const double squaredRadius = radius * radius;
+
+		const int64_t firstX = std::max(GetCellX(position.X - radius), (int64_t)0);
+		const int64_t lastX = std::min(GetCellX(position.X + radius), m_CellCountX - 1);
+		const int64_t firstY = std::max(GetCellY(position.Y - radius), (int64_t)0);
+		const int64_t lastY = std::min(GetCellY(position.Y + radius), m_CellCountY - 1);
+
+		for (int64_t y = firstY; y <= lastY; y++)
+			for (int64_t x = firstX; x <= lastX; x++)
+				ForEachInCell(x, y, [&](const Entry& entry)
+				{
+					if ((entry.X - position.X) * (entry.X - position.X) + (entry.Y - position.Y) * (entry.Y - position.Y) <= squaredRadius)
+						SNIDs.push_back(entry.SNID);
+				});
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace WSN
+{
+	/// <summary>
+	/// Uniform grid over the positions of a subset of the sensor nodes, sized for about 2 nodes per cell.
+	/// Queries compare squared distances and return SNIDs, the nodes of every cell are stored contiguously.
+	/// </summary>
+	class SpatialGrid
+	{
+	public:
+		SpatialGrid(const std::vector<SensorNode>& sensorNodes, const std::vector<uint64_t>& SNIDs);
+
+		/// <summary>
+		/// The (at most) k nodes closest to position within maxDistance, nearest first, ties to the smaller SNID
+		/// </summary>
+		void KNearest(const Position& position, size_t k, double maxDistance, std::vector<uint64_t>& SNIDs) const;
+
+		/// <summary>
+		/// The nodes within radius of position (inclusive), in no particular order
+		/// </summary>
+		void WithinRadius(const Position& position, double radius, std::vector<uint64_t>& SNIDs) const;
+
+		static inline double GetSquaredDistance(const Position& p1, const Position& p2)
+		{
+			return (p1.X - p2.X) * (p1.X - p2.X) + (p1.Y - p2.Y) * (p1.Y - p2.Y);
+		}
+
+	private:
+		struct Entry
+		{
+			double X;
+			double Y;
+			uint64_t SNID;
+		};
+
+		inline int64_t GetCellX(double x) const { return (int64_t)std::floor((x - m_MinX) / m_CellSize); }
+		inline int64_t GetCellY(double y) const { return (int64_t)std::floor((y - m_MinY) / m_CellSize); }
+
+		template<typename Function>
+		void ForEachInCell(int64_t cellX, int64_t cellY, Function function) const
+		{
+			if (cellX < 0 || cellY < 0 || cellX >= m_CellCountX || cellY >= m_CellCountY)
+				return;
+
+			size_t cell = cellY * m_CellCountX + cellX;
+			for (size_t i = m_CellStarts[cell]; i < m_CellStarts[cell + 1]; i++)
+				function(m_Entries[i]);
+		}
+
+		double m_MinX = 0;
+		double m_MinY = 0;
+		double m_CellSize = 1;
+		int64_t m_CellCountX = 1;
+		int64_t m_CellCountY = 1;
+
+		// the entries of cell c are m_Entries[m_CellStarts[c], m_CellStarts[c + 1])
+		std::vector<size_t> m_CellStarts;
+		std::vector<Entry> m_Entries;
+	};
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+namespace WSN
+{
+	/// <summary>
+	/// What InnerRun tracks as it goes, updated incrementally so that checking for termination is O(1) per event
+	/// </summary>
+	struct SimulationProgress
+	{
+		// sensor nodes whose m_TotalDataSent has not exceeded TotalDurationToBeTransferred yet
+		uint64_t PendingSNCount = 0;
+		// data that reached the base station
+		double TransferredTotalDuration = 0;
+		double CurrentTime = 0;
+		uint64_t EventCount = 0;
+		std::chrono::steady_clock::time_point StartTime;
+	};
+
+	/// <summary>
+	/// Decides when InnerRun stops, checked after every event
+	/// </summary>
+	class TerminationCondition
+	{
+	public:
+		virtual ~TerminationCondition() = default;
+
+		virtual bool IsReached(const SimulationProgress& progress) const = 0;
+	};
+
+	/// <summary>
+	/// Every sensor node has sent more than TotalDurationToBeTransferred to the base station
+	/// </summary>
+	class AllSNsDelivered : public TerminationCondition
+	{
+	public:
+		bool IsReached(const SimulationProgress& progress) const override { return progress.PendingSNCount == 0; }
+	};
+
+	/// <summary>
+	/// The base station has received totalDuration of data, from any sensor node
+	/// </summary>
+	class BaseStationTotal : public TerminationCondition
+	{
+	public:
+		BaseStationTotal(double totalDuration) : m_TotalDuration(totalDuration) {}
+
+		bool IsReached(const SimulationProgress& progress) const override { return progress.TransferredTotalDuration >= m_TotalDuration; }
+
+	private:
+		double m_TotalDuration;
+	};
+
+	/// <summary>
+	/// The run has taken limit of wall clock time
+	/// </summary>
+	class WallTime : public TerminationCondition
+	{
+	public:
+		WallTime(std::chrono::steady_clock::duration limit) : m_Limit(limit) {}
+
+		bool IsReached(const SimulationProgress& progress) const override { return std::chrono::steady_clock::now() - progress.StartTime >= m_Limit; }
+
+	private:
+		std::chrono::steady_clock::duration m_Limit;
+	};
+
+	/// <summary>
+	/// maxEventCount events have been handled
+	/// </summary>
+	class EventBudget : public TerminationCondition
+	{
+	public:
+		EventBudget(uint64_t maxEventCount) : m_MaxEventCount(maxEventCount) {}
+
+		bool IsReached(const SimulationProgress& progress) const override { return progress.EventCount >= m_MaxEventCount; }
+
+	private:
+		uint64_t m_MaxEventCount;
+	};
+
+	/// <summary>
+	/// Stops as soon as one of conditions is reached, e.g. all sensor nodes delivered within a wall time limit
+	/// </summary>
+	class AnyOf : public TerminationCondition
+	{
+	public:
+		AnyOf(std::vector<std::shared_ptr<const TerminationCondition>> conditions) : m_Conditions(std::move(conditions)) {}
+
+		bool IsReached(const SimulationProgress& progress) const override
+		{
+			for (const auto& condition : m_Conditions)
+				if (condition->IsReached(progress))
+					return true;
+			return false;
+		}
+
+	private:
+		std::vector<std::shared_ptr<const TerminationCondition>> m_Conditions;
+	};
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+namespace WSN
+{
+	/// <summary>
+	/// Fixed set of worker threads shared by every Simulation.
+	/// ParallelFor hands out index chunks from a shared counter, so idle workers keep pulling work
+	/// from whatever is left of the range. The calling thread takes part in the loop as well, which
+	/// keeps nested ParallelFor calls from deadlocking when every worker is already busy.
+	/// </summary>
+	class ThreadPool
+	{
+	public:
+		ThreadPool(unsigned int threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		static ThreadPool& Get();
+
+		inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+
+		/// <summary>
+		/// Calls func(i) for every i in [0, count). Returns once every index is done and
+		/// rethrows the first exception thrown by func, if any.
+		/// </summary>
+		template<typename F>
+		void ParallelFor(long long count, F&& func, long long chunkSize = 1);
+
+	private:
+		void Enqueue(std::function<void()> task);
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Workers;
+		std::deque<std::function<void()>> m_Tasks;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		bool m_Stopping = false;
+	};
+
+	template<typename F>
+	void ThreadPool::ParallelFor(long long count, F&& func, long long chunkSize)
+	{
+		if (count <= 0)
+			return;
+
+		chunkSize = std::max(chunkSize, 1LL);
+		long long chunkCount = (count + chunkSize - 1) / chunkSize;
+
+		struct SharedState
+		{
+			std::atomic<long long> NextChunk = 0;
+			long long FinishedChunks = 0;
+			std::exception_ptr Exception;
+			std::mutex Mutex;
+			std::condition_variable Condition;
+		};
+
+		// helpers may start after this call has returned, so they only ever touch the shared state
+		// once they have claimed a chunk, and claiming fails once every chunk is handed out
+		auto state = std::make_shared<SharedState>();
+
+		auto runChunks = [state, count, chunkSize, chunkCount, &func]()
+		{
+			while (true)
+			{
+				long long chunk = state->NextChunk.fetch_add(1);
+				if (chunk >= chunkCount)
+					return;
+
+				long long begin = chunk * chunkSize;
+				long long end = std::min(begin + chunkSize, count);
+
+				std::exception_ptr exception;
+				try
+				{
+					for (long long i = begin; i < end; i++)
+						func(i);
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(state->Mutex);
+				if (exception && !state->Exception)
+					state->Exception = exception;
+				if (++state->FinishedChunks == chunkCount)
+					state->Condition.notify_all();
+			}
+		};
+
+		long long helperCount = std::min<long long>(GetThreadCount(), chunkCount - 1);
+		for (long long i = 0; i < helperCount; i++)
+			Enqueue(runChunks);
+
+		runChunks();
+
+		std::unique_lock<std::mutex> lock(state->Mutex);
+		state->Condition.wait(lock, [&]() { return state->FinishedChunks == chunkCount; });
+
+		if (state->Exception)
+			std::rethrow_exception(state->Exception);
+	}
+}